@@ -0,0 +1,112 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Minimal header-only benchmark harness, runs on PC and on MCUs with a cycle counter
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+// CALLBACK_BENCHMARK_TIMESTAMP(): Expression returning the current time as uint64_t (e.g.
+// DWT->CYCCNT on Cortex-M). Defaults to std::chrono::steady_clock in nanoseconds.
+#ifndef CALLBACK_BENCHMARK_TIMESTAMP
+#include <chrono>
+#define CALLBACK_BENCHMARK_TIMESTAMP()                                               \
+    ((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(                 \
+         std::chrono::steady_clock::now().time_since_epoch())                        \
+         .count())
+#define CALLBACK_BENCHMARK_UNIT "ns"
+#endif
+
+#ifndef CALLBACK_BENCHMARK_UNIT
+#define CALLBACK_BENCHMARK_UNIT "ticks"
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCHMARK_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define BENCHMARK_NOINLINE __declspec(noinline)
+#else
+#define BENCHMARK_NOINLINE
+#endif
+
+/**
+ * @brief Keep the compiler from optimizing a value (and its computation) away
+ *
+ * @tparam T
+ * @param value
+ */
+template <typename T>
+inline void benchmarkKeep(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief Keep the compiler from assuming anything about the memory, e.g. to reload a pointer
+ *
+ */
+inline void benchmarkClobber() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+/**
+ * @brief Hide a value from the optimizer, so e.g. a function pointer can not be devirtualized
+ *
+ * @tparam T
+ * @param value
+ * @return T
+ */
+template <typename T>
+inline T benchmarkOpaque(T value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : "+m"(value) : : "memory");
+#endif
+    return value;
+}
+
+/**
+ * @brief Run body(iteration) iterations times and print the time per iteration
+ *
+ * @tparam F
+ * @param name Name printed in front of the result
+ * @param iterations
+ * @param body Called with the index of the iteration
+ * @return double Time per iteration in CALLBACK_BENCHMARK_UNIT
+ */
+template <typename F>
+double benchmarkRun(const char *name, const uint64_t iterations, const F &body) {
+    // Warm up caches and branch predictors
+    for (uint64_t i = 0; i < iterations / 16 + 1; i++) {
+        body(i);
+    }
+
+    const uint64_t start = CALLBACK_BENCHMARK_TIMESTAMP();
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        body(i);
+    }
+
+    const uint64_t end = CALLBACK_BENCHMARK_TIMESTAMP();
+    const double perIteration = (double)(end - start) / (double)iterations;
+
+    printf("%-52s %10.2f %s/op\n", name, perIteration, CALLBACK_BENCHMARK_UNIT);
+    return perIteration;
+}
+
+/**
+ * @brief Print a header to group the following results
+ *
+ * @param name
+ */
+inline void benchmarkGroup(const char *name) { printf("\n--- %s\n", name); }
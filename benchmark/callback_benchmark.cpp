@@ -0,0 +1,255 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Measures the overhead of Callback against direct calls, function pointers,
+ * std::function and virtual calls
+ *
+ * Build (PC): g++ -O2 -std=c++14 -DPC_BUILD -DCONFIG_CALLBACK_INCLUDE_POINT_TO_SAME -I. \
+ *                 benchmark/callback_benchmark.cpp -o callback_benchmark
+ *
+ * On an MCU define CALLBACK_BENCHMARK_TIMESTAMP() (e.g. DWT->CYCCNT), CALLBACK_BENCHMARK_NO_STD to
+ * skip std::function and CALLBACK_BENCHMARK_MAX_ARRAY to fit the RAM.
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include "benchmark.hpp"
+#include "callback.hpp"
+
+#ifndef CALLBACK_BENCHMARK_NO_STD
+#include <functional>
+#endif
+
+#ifndef CALLBACK_BENCHMARK_ITERATIONS
+#define CALLBACK_BENCHMARK_ITERATIONS 10000000
+#endif
+
+#ifndef CALLBACK_BENCHMARK_MAX_ARRAY
+#ifdef PC_BUILD
+#define CALLBACK_BENCHMARK_MAX_ARRAY (1024 * 1024)
+#else
+#define CALLBACK_BENCHMARK_MAX_ARRAY 1024
+#endif
+#endif
+
+static const uint64_t iterations = CALLBACK_BENCHMARK_ITERATIONS;
+
+// -------------- Targets
+
+static uint32_t counter = 0;
+
+BENCHMARK_NOINLINE uint32_t function(uint32_t value) { return counter += value; }
+
+class Interface {
+   public:
+    virtual uint32_t call(uint32_t value) = 0;
+    virtual ~Interface() {}
+};
+
+class Target : public Interface {
+   public:
+    uint32_t state = 0;
+
+    BENCHMARK_NOINLINE uint32_t method(uint32_t value) { return state += value; }
+    uint32_t inlineMethod(uint32_t value) { return state += value; }
+    uint32_t call(uint32_t value) override { return state += value; }
+};
+
+// -------------- Benchmarks
+
+static void benchmarkInvocation() {
+    benchmarkGroup("Invocation");
+
+    Target target;
+
+    benchmarkRun("direct call", iterations,
+                 [](uint64_t i) { benchmarkKeep(function((uint32_t)i)); });
+
+    uint32_t (*const functionPointer)(uint32_t) = benchmarkOpaque(&function);
+    benchmarkRun("raw function pointer", iterations, [&](uint64_t i) {
+        benchmarkKeep(benchmarkOpaque(functionPointer)((uint32_t)i));
+    });
+
+    Interface *const interface = benchmarkOpaque((Interface *)&target);
+    benchmarkRun("virtual interface", iterations, [&](uint64_t i) {
+        benchmarkKeep(benchmarkOpaque(interface)->call((uint32_t)i));
+    });
+
+#ifndef CALLBACK_BENCHMARK_NO_STD
+    const std::function<uint32_t(uint32_t)> stdFunction(&function);
+    benchmarkRun("std::function (function)", iterations, [&](uint64_t i) {
+        benchmarkKeep(benchmarkOpaque(&stdFunction)->operator()((uint32_t)i));
+    });
+
+    const std::function<uint32_t(uint32_t)> stdMethod(
+        [&target](uint32_t value) { return target.method(value); });
+    benchmarkRun("std::function (lambda to method)", iterations, [&](uint64_t i) {
+        benchmarkKeep(benchmarkOpaque(&stdMethod)->operator()((uint32_t)i));
+    });
+#endif
+
+    const Callback<uint32_t, uint32_t> toFunction(&function);
+    benchmarkRun("Callback (FunctionCaller)", iterations, [&](uint64_t i) {
+        benchmarkKeep(benchmarkOpaque(&toFunction)->call((uint32_t)i));
+    });
+
+    const Callback<uint32_t, uint32_t> toMethod(&target, &Target::method);
+    benchmarkRun("Callback (MethodCaller)", iterations, [&](uint64_t i) {
+        benchmarkKeep(benchmarkOpaque(&toMethod)->call((uint32_t)i));
+    });
+
+    const auto toStaticFunction = Callback<uint32_t, uint32_t>::bind<&function>();
+    benchmarkRun("Callback (bind<&function>)", iterations, [&](uint64_t i) {
+        benchmarkKeep(benchmarkOpaque(&toStaticFunction)->call((uint32_t)i));
+    });
+
+    const auto toStaticMethod =
+        Callback<uint32_t, uint32_t>::bind<Target, &Target::inlineMethod>(&target);
+    benchmarkRun("Callback (bind<T, &T::method>, inlined)", iterations, [&](uint64_t i) {
+        benchmarkKeep(benchmarkOpaque(&toStaticMethod)->call((uint32_t)i));
+    });
+
+    const Callback<uint32_t, uint32_t> toLambda(
+        [&target](uint32_t value) { return target.inlineMethod(value); });
+    benchmarkRun("Callback (lambda, inlined)", iterations, [&](uint64_t i) {
+        benchmarkKeep(benchmarkOpaque(&toLambda)->call((uint32_t)i));
+    });
+
+    const Callback<uint32_t, uint32_t> empty;
+    benchmarkRun("Callback (empty)", iterations,
+                 [&](uint64_t i) { benchmarkKeep(benchmarkOpaque(&empty)->call((uint32_t)i)); });
+}
+
+static void benchmarkConstruction() {
+    benchmarkGroup("Construction and copy");
+
+    Target target;
+
+    benchmarkRun("construct Callback (function)", iterations, [&](uint64_t) {
+        Callback<uint32_t, uint32_t> callback(benchmarkOpaque(&function));
+        benchmarkKeep(callback);
+    });
+
+    benchmarkRun("construct Callback (method)", iterations, [&](uint64_t) {
+        Callback<uint32_t, uint32_t> callback(benchmarkOpaque(&target), &Target::method);
+        benchmarkKeep(callback);
+    });
+
+    benchmarkRun("construct Callback (lambda)", iterations, [&](uint64_t) {
+        Target *const object = benchmarkOpaque(&target);
+        Callback<uint32_t, uint32_t> callback(
+            [object](uint32_t value) { return object->inlineMethod(value); });
+        benchmarkKeep(callback);
+    });
+
+#ifndef CALLBACK_BENCHMARK_NO_STD
+    benchmarkRun("construct std::function (lambda)", iterations, [&](uint64_t) {
+        Target *const object = benchmarkOpaque(&target);
+        std::function<uint32_t(uint32_t)> function(
+            [object](uint32_t value) { return object->inlineMethod(value); });
+        benchmarkKeep(function);
+    });
+#endif
+
+    const Callback<uint32_t, uint32_t> source(&target, &Target::method);
+    benchmarkRun("copy Callback", iterations, [&](uint64_t) {
+        Callback<uint32_t, uint32_t> copy(*benchmarkOpaque(&source));
+        benchmarkKeep(copy);
+    });
+
+#ifndef CALLBACK_BENCHMARK_NO_STD
+    const std::function<uint32_t(uint32_t)> stdSource(
+        [&target](uint32_t value) { return target.method(value); });
+    benchmarkRun("copy std::function", iterations, [&](uint64_t) {
+        std::function<uint32_t(uint32_t)> copy(*benchmarkOpaque(&stdSource));
+        benchmarkKeep(copy);
+    });
+#endif
+}
+
+#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
+static void benchmarkCompare() {
+    benchmarkGroup("pointToSame");
+
+    Target target, other;
+
+    const Callback<uint32_t, uint32_t> a(&target, &Target::method);
+    const Callback<uint32_t, uint32_t> b(&target, &Target::method);
+    const Callback<uint32_t, uint32_t> c(&other, &Target::method);
+    const Callback<uint32_t, uint32_t> d(&function);
+
+    benchmarkRun("pointToSame (equal)", iterations,
+                 [&](uint64_t) { benchmarkKeep(benchmarkOpaque(&a)->pointToSame(b)); });
+    benchmarkRun("pointToSame (other object)", iterations,
+                 [&](uint64_t) { benchmarkKeep(benchmarkOpaque(&a)->pointToSame(c)); });
+    benchmarkRun("pointToSame (other caller type)", iterations,
+                 [&](uint64_t) { benchmarkKeep(benchmarkOpaque(&a)->pointToSame(d)); });
+}
+#endif
+
+static void benchmarkArrays() {
+    benchmarkGroup("Arrays (per element)");
+
+    char name[64];
+
+    for (std::size_t size = 1024; size <= CALLBACK_BENCHMARK_MAX_ARRAY; size *= 32) {
+        Target *const targets = new Target[size];
+        Callback<uint32_t, uint32_t> *const callbacks = new Callback<uint32_t, uint32_t>[size];
+        Interface **const interfaces = new Interface *[size];
+
+        for (std::size_t i = 0; i < size; i++) {
+            callbacks[i] = Callback<uint32_t, uint32_t>(&targets[i], &Target::method);
+            interfaces[i] = &targets[i];
+        }
+
+        const uint64_t rounds = iterations / size + 1;
+
+        snprintf(name, sizeof(name), "Callback (MethodCaller) x%zu", size);
+        benchmarkRun(name, rounds * size, [&](uint64_t i) {
+            benchmarkKeep(callbacks[i % size].call((uint32_t)i));
+        });
+
+        snprintf(name, sizeof(name), "virtual interface x%zu", size);
+        benchmarkRun(name, rounds * size, [&](uint64_t i) {
+            benchmarkKeep(interfaces[i % size]->call((uint32_t)i));
+        });
+
+#ifndef CALLBACK_BENCHMARK_NO_STD
+        std::function<uint32_t(uint32_t)> *const functions =
+            new std::function<uint32_t(uint32_t)>[size];
+
+        for (std::size_t i = 0; i < size; i++) {
+            Target *const target = &targets[i];
+            functions[i] = [target](uint32_t value) { return target->method(value); };
+        }
+
+        snprintf(name, sizeof(name), "std::function x%zu", size);
+        benchmarkRun(name, rounds * size,
+                     [&](uint64_t i) { benchmarkKeep(functions[i % size]((uint32_t)i)); });
+
+        delete[] functions;
+#endif
+
+        delete[] interfaces;
+        delete[] callbacks;
+        delete[] targets;
+    }
+}
+
+int main() {
+    printf("sizeof(Callback<uint32_t, uint32_t>) = %zu Byte\n",
+           sizeof(Callback<uint32_t, uint32_t>));
+#ifndef CALLBACK_BENCHMARK_NO_STD
+    printf("sizeof(std::function<uint32_t(uint32_t)>) = %zu Byte\n",
+           sizeof(std::function<uint32_t(uint32_t)>));
+#endif
+
+    benchmarkInvocation();
+    benchmarkConstruction();
+#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
+    benchmarkCompare();
+#endif
+    benchmarkArrays();
+
+    return 0;
+}
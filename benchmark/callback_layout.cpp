@@ -0,0 +1,330 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Checks and reports the memory layout of Callback and the other types of this library,
+ * so size changes between compilers, targets and configurations do not go unnoticed
+ *
+ * Build (PC): g++ -std=c++14 -DPC_BUILD -I. benchmark/callback_layout.cpp -o callback_layout
+ *
+ * The layout is checked with static_asserts, so compiling it for a target (with the configuration
+ * defines used there) already fails on a change. Running it prints the sizes and checks that
+ * Callbacks to Methods of all inheritance models are called correctly. Define
+ * CALLBACK_LAYOUT_MAX_SIZE to additionally fail the build once sizeof(Callback<void>) exceeds a
+ * memory budget.
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <type_traits>
+
+#include "callback.hpp"
+#include "callback_atomic.hpp"
+#include "callback_marshal.hpp"
+#include "callback_pool.hpp"
+#include "callback_ref.hpp"
+#include "callback_registry.hpp"
+#include "callback_target.hpp"
+#include "callback_unique.hpp"
+
+// -------------- Expected layout
+
+/**
+ * @brief Size of an InplaceCallback consisting of its vptr (if it has a compare base), invoker
+ * and buffer, padded to the alignment of a pointer
+ *
+ * @tparam BufferSize
+ * @return constexpr std::size_t
+ */
+template <std::size_t BufferSize>
+constexpr std::size_t expectedCallbackSize() {
+#ifdef CONFIG_CALLBACK_NO_COMPARE_BASE
+    return (sizeof(void (*)()) + BufferSize + alignof(void *) - 1) / alignof(void *) *
+           alignof(void *);
+#else
+    return sizeof(void *) +
+           (sizeof(void (*)()) + BufferSize + alignof(void *) - 1) / alignof(void *) *
+               alignof(void *);
+#endif
+}
+
+template <std::size_t BufferSize>
+constexpr bool checkCallbackLayout() {
+    return sizeof(InplaceCallback<BufferSize, void>) == expectedCallbackSize<BufferSize>() &&
+           sizeof(InplaceCallback<BufferSize, uint32_t, uint32_t>) ==
+               expectedCallbackSize<BufferSize>() &&
+           alignof(InplaceCallback<BufferSize, void>) == alignof(void *);
+}
+
+static_assert(checkCallbackLayout<CALLBACK_INTERNAL_BUFFER_SIZE>(),
+              "Callback has an unexpected layout!");
+static_assert(checkCallbackLayout<sizeof(void *)>(), "InplaceCallback has an unexpected layout!");
+static_assert(checkCallbackLayout<2 * sizeof(void *)>(),
+              "InplaceCallback has an unexpected layout!");
+static_assert(checkCallbackLayout<4 * sizeof(void *)>(),
+              "InplaceCallback has an unexpected layout!");
+static_assert(checkCallbackLayout<8 * sizeof(void *)>(),
+              "InplaceCallback has an unexpected layout!");
+static_assert(checkCallbackLayout<13>(), "InplaceCallback has an unexpected layout!");
+
+#ifdef CONFIG_CALLBACK_NO_COMPARE_BASE
+static_assert(std::is_trivially_copyable<Callback<void>>::value &&
+                  std::is_standard_layout<Callback<void>>::value,
+              "Callback has to be a plain value without the compare base!");
+#endif
+
+#ifdef CALLBACK_LAYOUT_MAX_SIZE
+static_assert(sizeof(Callback<void>) <= CALLBACK_LAYOUT_MAX_SIZE,
+              "Callback exceeds CALLBACK_LAYOUT_MAX_SIZE!");
+#endif
+
+static_assert(sizeof(CallbackRef<void>) == sizeof(void *) + sizeof(void (*)()),
+              "CallbackRef has to only consist of two pointers!");
+static_assert(sizeof(UniqueCallback<void>) == 2 * sizeof(void (*)()) +
+                                                  CALLBACK_INTERNAL_BUFFER_SIZE,
+              "UniqueCallback has an unexpected layout!");
+static_assert(sizeof(CallbackHandle) == 4, "CallbackHandle has to be 4 Byte!");
+static_assert(sizeof(CallbackTargetHandle) == 4, "CallbackTargetHandle has to be 4 Byte!");
+
+class Tracked : public CallbackTarget {
+   public:
+    uint32_t get() { return 5; }
+};
+
+// A tracked Callback to a runtime Method holds the Method pointer and the handle
+static_assert(sizeof(CallbackTrackedMethod<Tracked, uint32_t (Tracked::*)()>) <=
+                  CALLBACK_INTERNAL_BUFFER_SIZE,
+              "Tracked Callbacks have to fit the default buffer!");
+
+// -------------- 32 bit targets
+
+// Sizes on ILP32 targets with GCC and Clang (e.g. Cortex-M), checked on every host so a type
+// outgrowing the 32 bit buffer fails the build on a PC as well. Only types whose size does not
+// depend on the pointer size are taken as they are.
+static constexpr std::size_t ilp32Pointer = 4;
+static constexpr std::size_t ilp32MethodPointer = 2 * ilp32Pointer;
+static constexpr std::size_t ilp32BufferSize = ilp32Pointer + ilp32MethodPointer;
+
+/**
+ * @brief Size of a struct of the given member sizes on ILP32, all aligned to at most 4 Byte
+ *
+ * @param size Sum of the member sizes
+ * @return constexpr std::size_t
+ */
+constexpr std::size_t ilp32Size(const std::size_t size) {
+    return (size + ilp32Pointer - 1) / ilp32Pointer * ilp32Pointer;
+}
+
+static_assert(alignof(CallbackTargetHandle) <= ilp32Pointer,
+              "CallbackTargetHandle has to be aligned to at most 4 Byte!");
+static_assert(ilp32Size(ilp32MethodPointer + sizeof(CallbackTargetHandle)) <= ilp32BufferSize,
+              "Tracked Callbacks to runtime Methods have to fit the 32 bit buffer!");
+static_assert(ilp32Size(sizeof(CallbackTargetHandle)) <= ilp32BufferSize,
+              "Tracked Callbacks to compile time Methods have to fit the 32 bit buffer!");
+static_assert(ilp32Size(2 * ilp32Pointer) <= ilp32BufferSize,
+              "Callbacks of bindOn() have to fit the 32 bit buffer!");
+
+#if defined(__GNUC__) || defined(__clang__)
+// On a 32 bit target the model above has to be the real layout
+static_assert(sizeof(void *) != ilp32Pointer ||
+                  (sizeof(void (CallbackUnknownClass::*)()) == ilp32MethodPointer &&
+                   sizeof(CallbackTrackedMethod<Tracked, uint32_t (Tracked::*)()>) ==
+                       ilp32Size(ilp32MethodPointer + sizeof(CallbackTargetHandle))),
+              "The ILP32 model does not match this target!");
+#endif
+
+// -------------- Method pointers of all inheritance models
+
+class Single {
+   public:
+    uint32_t value = 1;
+
+    uint32_t get() { return value; }
+};
+
+class OtherBase {
+   public:
+    uint32_t other = 2;
+};
+
+class Multiple : public OtherBase, public Single {
+   public:
+    uint32_t getOther() { return other + value; }
+};
+
+class Virtual : public virtual Single {
+   public:
+    uint32_t getVirtual() { return value + 3; }
+};
+
+// Its Method pointers are formed before the class is defined
+class LateDefined;
+using LateMethod = uint32_t (LateDefined::*)();
+static const std::size_t lateMethodSize = sizeof(LateMethod);
+static const std::size_t lateMethodAlign = alignof(LateMethod);
+
+class LateDefined : public Virtual, public OtherBase {
+   public:
+    uint32_t getLate() { return value + other + 4; }
+};
+
+static_assert(sizeof(&Single::get) <= CALLBACK_INTERNAL_BUFFER_SIZE - sizeof(void *) &&
+                  sizeof(&Multiple::getOther) <= CALLBACK_INTERNAL_BUFFER_SIZE - sizeof(void *) &&
+                  sizeof(&Virtual::getVirtual) <= CALLBACK_INTERNAL_BUFFER_SIZE - sizeof(void *) &&
+                  sizeof(LateMethod) <= CALLBACK_INTERNAL_BUFFER_SIZE - sizeof(void *),
+              "Method pointers have to fit the buffer next to the Object!");
+
+// -------------- Report
+
+static bool failed = false;
+
+#ifdef PC_BUILD
+static const bool pcBuild = true;
+#else
+static const bool pcBuild = false;
+#endif
+
+#ifdef USE_SDK_CONFIG
+static const bool useSdkConfig = true;
+#else
+static const bool useSdkConfig = false;
+#endif
+
+#ifdef CONFIG_CALLBACK_NO_COMPARE_BASE
+static const bool noCompareBase = true;
+#else
+static const bool noCompareBase = false;
+#endif
+
+#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
+static const bool includePointToSame = true;
+#else
+static const bool includePointToSame = false;
+#endif
+
+#ifdef CONFIG_CALLBACK_NULL_INVOKER
+static const bool nullInvoker = true;
+#else
+static const bool nullInvoker = false;
+#endif
+
+#ifdef CONFIG_CALLBACK_INSTRUMENT
+static const bool instrument = true;
+#else
+static const bool instrument = false;
+#endif
+
+static void reportFlag(const char *name, const bool enabled) {
+    printf("  %-50s %6s\n", name, enabled ? "on" : "off");
+}
+
+static void reportValue(const char *name, const std::size_t value) {
+    printf("  %-50s %6zu\n", name, value);
+}
+
+template <typename T>
+static void report(const char *name) {
+    printf("%-52s %6zu %6zu\n", name, sizeof(T), alignof(T));
+}
+
+static void check(const char *name, const uint32_t result, const uint32_t expected) {
+    if (result != expected) {
+        printf("FAILED: %s returned %u instead of %u\n", name, (unsigned int)result,
+               (unsigned int)expected);
+        failed = true;
+    }
+}
+
+static void checkMethods() {
+    Single single;
+    Multiple multiple;
+    Virtual virtualInheritance;
+    LateDefined late;
+
+    check("Single", Callback<uint32_t>(&single, &Single::get)(), 1);
+    check("Multiple", Callback<uint32_t>(&multiple, &Multiple::getOther)(), 3);
+    check("Multiple (base)", Callback<uint32_t>(&multiple, &Multiple::get)(), 1);
+    check("Virtual", Callback<uint32_t>(&virtualInheritance, &Virtual::getVirtual)(), 4);
+    check("Virtual (base)", Callback<uint32_t>(&virtualInheritance, &Virtual::get)(), 1);
+    check("LateDefined", Callback<uint32_t>(&late, &LateDefined::getLate)(), 7);
+
+    Tracked tracked;
+    check("Tracked", trackedCallback(&tracked, &Tracked::get)(), 5);
+}
+
+int main() {
+    printf("Compiler: ");
+#if defined(__clang__)
+    printf("Clang %d.%d", __clang_major__, __clang_minor__);
+#elif defined(__GNUC__)
+    printf("GCC %d.%d", __GNUC__, __GNUC_MINOR__);
+#elif defined(_MSC_VER)
+    printf("MSVC %d", _MSC_VER);
+#else
+    printf("unknown");
+#endif
+    printf(", C++ %ld, %zu bit\n", (long)__cplusplus, sizeof(void *) * 8);
+
+    printf("Configuration:\n");
+    reportFlag("PC_BUILD", pcBuild);
+    reportFlag("USE_SDK_CONFIG", useSdkConfig);
+    reportFlag("CONFIG_CALLBACK_NO_COMPARE_BASE", noCompareBase);
+    reportFlag("CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME", includePointToSame);
+    reportFlag("CONFIG_CALLBACK_NULL_INVOKER", nullInvoker);
+    reportFlag("CONFIG_CALLBACK_INSTRUMENT", instrument);
+    reportValue("CALLBACK_INTERNAL_BUFFER_SIZE", CALLBACK_INTERNAL_BUFFER_SIZE);
+    reportValue("CALLBACK_CACHE_LINE_SIZE", CALLBACK_CACHE_LINE_SIZE);
+    reportValue("CONFIG_CALLBACK_TARGET_SLOTS", CONFIG_CALLBACK_TARGET_SLOTS);
+    reportValue("CONFIG_CALLBACK_POOL_BLOCKS", CONFIG_CALLBACK_POOL_BLOCKS);
+    reportValue("CONFIG_CALLBACK_POOL_MAX_BLOCK_SIZE", CONFIG_CALLBACK_POOL_MAX_BLOCK_SIZE);
+    reportValue("CONFIG_CALLBACK_POOL_THREAD_CACHE", CONFIG_CALLBACK_POOL_THREAD_CACHE);
+    reportValue("CONFIG_CALLBACK_MAILBOX_ENTRY_SIZE", CONFIG_CALLBACK_MAILBOX_ENTRY_SIZE);
+#ifdef CONFIG_CALLBACK_INSTRUMENT
+    reportValue("CONFIG_CALLBACK_INSTRUMENT_THREADS", CONFIG_CALLBACK_INSTRUMENT_THREADS);
+    reportValue("CONFIG_CALLBACK_INSTRUMENT_ENTRIES", CONFIG_CALLBACK_INSTRUMENT_ENTRIES);
+#endif
+    printf("\n");
+
+    printf("%-52s %6s %6s\n", "", "sizeof", "align");
+    report<void *>("void *");
+    report<void (*)()>("Function pointer");
+    report<decltype(&Single::get)>("Method pointer (single inheritance)");
+    report<decltype(&Multiple::getOther)>("Method pointer (multiple inheritance)");
+    report<decltype(&Virtual::getVirtual)>("Method pointer (virtual inheritance)");
+    printf("%-52s %6zu %6zu\n", "Method pointer (declared before the class)", lateMethodSize,
+           lateMethodAlign);
+    report<void (CallbackUnknownClass::*)()>("Method pointer (undefined class)");
+
+    printf("\n");
+    report<Callback<void>>("Callback<void>");
+    report<Callback<uint32_t, uint32_t>>("Callback<uint32_t, uint32_t>");
+    report<Callback<CallbackNoexcept<void>>>("Callback<CallbackNoexcept<void>>");
+    report<InplaceCallback<sizeof(void *), void>>("InplaceCallback<sizeof(void *), void>");
+    report<InplaceCallback<2 * sizeof(void *), void>>("InplaceCallback<2 * sizeof(void *), void>");
+    report<InplaceCallback<4 * sizeof(void *), void>>("InplaceCallback<4 * sizeof(void *), void>");
+    report<InplaceCallback<8 * sizeof(void *), void>>("InplaceCallback<8 * sizeof(void *), void>");
+    report<CallbackRef<void>>("CallbackRef<void>");
+    report<UniqueCallback<void>>("UniqueCallback<void>");
+    report<AtomicCallbackSlot<void>>("AtomicCallbackSlot<void>");
+    report<CallbackHandle>("CallbackHandle");
+    report<CallbackHandleCall<uint32_t>>("CallbackHandleCall<uint32_t>");
+    report<CallbackTargetHandle>("CallbackTargetHandle");
+    report<PooledCallback<void>>("PooledCallback<void>");
+
+    Single single;
+    auto lambda = [&single]() { return single.get(); };
+    auto bigLambda = [&single, &lambda]() { return single.get() + lambda(); };
+    report<decltype(lambda)>("Lambda capturing a reference");
+    report<decltype(bigLambda)>("Lambda capturing two references");
+
+    checkMethods();
+
+    if (failed) {
+        return 1;
+    }
+
+    printf("\nLayout OK\n");
+    return 0;
+}
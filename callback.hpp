@@ -10,24 +10,316 @@
 #pragma once
 
 #include <stdint.h>
+#include <string.h>
 
 #include <new>
 #include <type_traits>
+#include <utility>
+
+#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
+#include <functional>
+#endif
 
 #ifdef USE_SDK_CONFIG
 #include "sdkconfig.h"
 #endif
 
-#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
-#include <typeinfo>
+#ifdef CONFIG_CALLBACK_INSTRUMENT
+#include "callback_instrument.hpp"
 #endif
 
-#if defined(PC_BUILD) && (__linux__ || __LP64__ || __APPLE__ || __MACH__)
-#define CALLBACK_INTERNAL_BUFFER_SIZE 32   // Byte
-#else
-#define CALLBACK_INTERNAL_BUFFER_SIZE 16   // Byte
+// CONFIG_CALLBACK_NO_COMPARE_BASE: Callback does not inherit CallbackCompare. Without the vptr it
+// is a trivially copyable, standard-layout value only consisting of its invoker and buffer.
+
+// CONFIG_CALLBACK_NULL_INVOKER: An empty Callback points to a shared no-op invoker returning R{}
+// instead of nullptr. call() is then an unconditional indirect call without a branch, R has to be
+// default constructible.
+
+// CONFIG_CALLBACK_INSTRUMENT: Every call is timed with CALLBACK_INSTRUMENT_TIMESTAMP() and
+// recorded into per thread histograms, see callback_instrument.hpp. Nothing is added without it.
+
+/**
+ * @brief Never defined, so a Method pointer of it has the biggest representation of the target.
+ * MSVC sizes Method pointers by the inheritance of the class, up to three or four words for
+ * classes it does not know, GCC and Clang always use two words.
+ *
+ */
+class CallbackUnknownClass;
+
+// Default buffer size of Callback. Only holds the bound data (object- and method-pointer), the
+// invoker is stored next to it. Use InplaceCallback to choose the size per Callback. E.g. 24 Byte
+// on 64 bit and 12 Byte on 32 bit targets with GCC and Clang.
+#ifndef CALLBACK_INTERNAL_BUFFER_SIZE
+#define CALLBACK_INTERNAL_BUFFER_SIZE \
+    (sizeof(void *) + sizeof(void (CallbackUnknownClass::*)()))   // Byte
 #endif
 
+/**
+ * @brief Type an Argument is passed on with inside of a Callback. Scalars are passed by value,
+ * other copyable values as const reference, so a by-value Argument is constructed only once, by
+ * the parameter of the destination. Move-only values and reference Arguments are forwarded as
+ * reference of their kind. Declare an Argument as T && to have it moved instead of copied.
+ *
+ * @tparam T Argument type as given to the Callback
+ */
+template <typename T>
+using CallbackForwardType = typename std::conditional<
+    std::is_scalar<T>::value, T,
+    typename std::conditional<!std::is_reference<T>::value &&
+                                  std::is_copy_constructible<T>::value,
+                              const T &, T &&>::type>::type;
+
+/**
+ * @brief Pass on an Argument received as CallbackForwardType<T>, like std::forward<T>()
+ *
+ * @tparam T Argument type as given to the Callback
+ * @param value
+ * @return constexpr CallbackForwardType<T>
+ */
+template <typename T>
+constexpr CallbackForwardType<T> callbackForward(
+    typename std::remove_reference<CallbackForwardType<T>>::type &value) noexcept {
+    return static_cast<CallbackForwardType<T>>(value);
+}
+
+/**
+ * @brief True if all Values are true
+ *
+ * @tparam Values
+ */
+template <bool... Values>
+struct CallbackBools {};
+
+template <bool... Values>
+using CallbackAll = std::is_same<CallbackBools<true, Values...>, CallbackBools<Values..., true>>;
+
+/**
+ * @brief A list of types
+ *
+ * @tparam Ts
+ */
+template <typename... Ts>
+struct CallbackTypes {};
+
+/**
+ * @brief True if values of the types Values (as deduced by forwarding references) can be passed
+ * as the Arguments of a Callback, one by one
+ *
+ * @tparam Values CallbackTypes of the value types
+ * @tparam Arguments CallbackTypes of the Argument types
+ */
+template <typename Values, typename Arguments, typename = void>
+struct CallbackAreConvertible : std::false_type {};
+
+template <typename... Us, typename... ArgTs>
+struct CallbackAreConvertible<CallbackTypes<Us...>, CallbackTypes<ArgTs...>,
+                              typename std::enable_if<sizeof...(Us) == sizeof...(ArgTs)>::type>
+    : CallbackAll<std::is_convertible<Us &&, ArgTs>::value...> {};
+
+/**
+ * @brief Constrains a forwarding call(Us &&...) of a Callback with the Arguments ArgTs, which
+ * passes the values on as CallbackForwardType<ArgTs>, so a by-value Argument is constructed only
+ * once
+ *
+ * @tparam Values CallbackTypes of the value types
+ * @tparam Arguments CallbackTypes of the Argument types
+ */
+template <typename Values, typename Arguments>
+using CallbackEnableIfConvertible =
+    typename std::enable_if<CallbackAreConvertible<Values, Arguments>::value>::type;
+
+/**
+ * @brief Check if a Functor can be called (as const) with ArgTs and its result converted to R.
+ * nothrow is additionally only true if the call is noexcept.
+ *
+ * @tparam F Functor type
+ * @tparam R Return type
+ * @tparam ArgTs Arguments
+ */
+template <typename F, typename R, typename... ArgTs>
+struct CallbackIsInvocable {
+   private:
+    template <typename G,
+              typename Result = decltype(std::declval<const G &>()(std::declval<ArgTs>()...))>
+    static constexpr bool _test(int) {
+        return std::is_void<R>::value || std::is_convertible<Result, R>::value;
+    }
+
+    template <typename G>
+    static constexpr bool _test(...) {
+        return false;
+    }
+
+    template <typename G, bool Nothrow = noexcept(std::declval<const G &>()(
+                              std::declval<ArgTs>()...))>
+    static constexpr bool _testNothrow(int) {
+        return Nothrow;
+    }
+
+    template <typename G>
+    static constexpr bool _testNothrow(...) {
+        return false;
+    }
+
+   public:
+    static constexpr bool value = _test<F>(0);
+    static constexpr bool nothrow = value && _testNothrow<F>(0);
+};
+
+/**
+ * @brief Check if a Method (-pointer) can be called on an Object of type T with ArgTs and its
+ * result converted to R. Covers const, volatile, noexcept and &-qualified Methods, T carries the
+ * qualifiers of the Object. nothrow is additionally only true if the call is noexcept.
+ *
+ * @tparam T Object type
+ * @tparam M Method (-pointer) type
+ * @tparam R Return type
+ * @tparam ArgTs Arguments
+ */
+template <typename T, typename M, typename R, typename... ArgTs>
+struct CallbackIsMethodInvocable {
+   private:
+    template <typename N, typename Result = decltype((std::declval<T &>().*std::declval<N>())(
+                              std::declval<ArgTs>()...))>
+    static constexpr bool _test(int) {
+        return std::is_void<R>::value || std::is_convertible<Result, R>::value;
+    }
+
+    template <typename N>
+    static constexpr bool _test(...) {
+        return false;
+    }
+
+    template <typename N, bool Nothrow = noexcept((std::declval<T &>().*std::declval<N>())(
+                              std::declval<ArgTs>()...))>
+    static constexpr bool _testNothrow(int) {
+        return Nothrow;
+    }
+
+    template <typename N>
+    static constexpr bool _testNothrow(...) {
+        return false;
+    }
+
+   public:
+    static constexpr bool value = std::is_member_function_pointer<M>::value && _test<M>(0);
+    static constexpr bool nothrow = value && _testNothrow<M>(0);
+};
+
+/**
+ * @brief Marks the return type of a Callback whose call() is noexcept, see
+ * InplaceCallback<BufferSize, R(ArgTs...) noexcept>
+ *
+ * @tparam R Return type
+ */
+template <typename R>
+struct CallbackNoexcept {};
+
+/**
+ * @brief Split a return type given to a Callback into the real return type and if it is noexcept
+ *
+ * @tparam R
+ */
+template <typename R>
+struct CallbackReturn : std::false_type {
+    using Type = R;
+};
+
+template <typename R>
+struct CallbackReturn<CallbackNoexcept<R>> : std::true_type {
+    using Type = R;
+};
+
+/**
+ * @brief A value followed by zeroed padding, so all Bytes of a buffer are defined even if it is
+ * initialized at compile time
+ *
+ * @tparam T Type of the value
+ * @tparam Padding Amount of Bytes after the value
+ */
+template <typename T, std::size_t Padding>
+struct CallbackPaddedValue {
+    constexpr CallbackPaddedValue(const T value) : value(value), padding{} {}
+
+    T value;
+    uint8_t padding[Padding];
+};
+
+template <typename T>
+struct CallbackPaddedValue<T, 0> {
+    constexpr CallbackPaddedValue(const T value) : value(value) {}
+
+    T value;
+};
+
+/**
+ * @brief The type at Index of a pack
+ *
+ * @tparam Index
+ * @tparam Ts
+ */
+template <std::size_t Index, typename... Ts>
+struct CallbackTypeAt;
+
+template <std::size_t Index, typename T, typename... Ts>
+struct CallbackTypeAt<Index, T, Ts...> : CallbackTypeAt<Index - 1, Ts...> {};
+
+template <typename T, typename... Ts>
+struct CallbackTypeAt<0, T, Ts...> {
+    using Type = T;
+};
+
+/**
+ * @brief A single value of CallbackValues
+ *
+ * @tparam Index Position of the value
+ * @tparam T
+ */
+template <std::size_t Index, typename T>
+struct CallbackValue {
+    template <typename U>
+    constexpr CallbackValue(U &&value) : value(std::forward<U>(value)) {}
+
+    T value;
+};
+
+/**
+ * @brief Minimal tuple, trivially copyable if all values are (unlike std::tuple), so it can be
+ * stored in the buffer of a Callback
+ *
+ * @tparam Indices std::index_sequence_for<Ts...>
+ * @tparam Ts
+ */
+template <typename Indices, typename... Ts>
+struct CallbackValues;
+
+template <std::size_t... Indices, typename... Ts>
+struct CallbackValues<std::index_sequence<Indices...>, Ts...> : CallbackValue<Indices, Ts>... {
+    template <typename... Us>
+    constexpr CallbackValues(Us &&...values)
+        : CallbackValue<Indices, Ts>(std::forward<Us>(values))... {}
+
+    template <std::size_t Index>
+    constexpr const typename CallbackTypeAt<Index, Ts...>::Type &get() const {
+        using Value = CallbackValue<Index, typename CallbackTypeAt<Index, Ts...>::Type>;
+        return static_cast<const Value &>(*this).value;
+    }
+};
+
+/**
+ * @brief Unique address per type, used instead of typeid so comparing works without RTTI. Not
+ * const, so the linker can never fold the tags of two types.
+ *
+ * @tparam T
+ */
+template <typename T>
+struct CallbackTypeTag {
+    static char id;
+};
+
+template <typename T>
+char CallbackTypeTag<T>::id = 0;
+
 /**
  * @brief Simple Interface to compare Callbacks of unknown Type
  *
@@ -36,6 +328,13 @@ class CallbackCompare {
    public:
 #ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
     virtual bool pointToSame(const CallbackCompare &other) const = 0;
+
+    /**
+     * @brief Get the type tag (see CallbackTypeTag) of the concrete Callback type
+     *
+     * @return const void*
+     */
+    virtual const void *callbackType() const = 0;
 #endif
 
     virtual bool isCallbackSet() const = 0;
@@ -47,71 +346,399 @@ class CallbackCompare {
  * NOTE: Will never change its pointing to callback. The callback can only point to something at
  * construction and deleted or killed afterwards, but the callback can not change.
  *
- * @tparam R Return type
+ * Besides Functions and Methods, any trivially copyable Functor (e.g. a Lambda) can be stored, as
+ * long as it fits into the internal buffer.
+ *
+ * @tparam BufferSize Size of the internal buffer holding the bound data
+ * @tparam R Return type, CallbackNoexcept<R> only accepts noexcept destinations and makes call()
+ * noexcept (see InplaceCallback<BufferSize, R(ArgTs...) noexcept>)
  * @tparam ArgTs Optional Arguments
  */
-template <typename R, typename... ArgTs>
-class Callback : public CallbackCompare {
+template <std::size_t BufferSize, typename R, typename... ArgTs>
+class InplaceCallback
+#ifndef CONFIG_CALLBACK_NO_COMPARE_BASE
+    : public CallbackCompare
+#endif
+{
    public:
     /**
-     * @brief Creates an empty callback with no destination
+     * @brief The type returned by call(), R without CallbackNoexcept
      *
      */
-    constexpr Callback() : _callbackSet(false) {}
+    using Return = typename CallbackReturn<R>::Type;
 
     /**
-     * @brief Construct a Callback using a Function (-pointer)
+     * @brief If true, call() is noexcept and only noexcept destinations are accepted
      *
-     * @param func Function to be called on call()
      */
-    Callback(R (*const func)(ArgTs... args)) : _callbackSet(true) {
-        _checkSizeFit<FunctionCaller, CALLBACK_INTERNAL_BUFFER_SIZE>();
+    static constexpr bool isNoexcept = CallbackReturn<R>::value;
 
-        // Special Case: Check for nullptr
-        if (func == nullptr) {
-            _callbackSet = false;
-            return;
-        }
+    /**
+     * @brief Function (-pointer) type the Callback can point to, noexcept for noexcept Callbacks
+     *
+     */
+#ifdef __cpp_noexcept_function_type
+    using Function = Return (*)(ArgTs...) noexcept(isNoexcept);
+#else
+    using Function = Return (*)(ArgTs...);
+#endif
 
-        // Construct the FunctionCaller in the internal buffer
-        new (_buffer) FunctionCaller(func);
+    /**
+     * @brief Creates an empty callback with no destination
+     *
+     */
+    constexpr InplaceCallback() : _invoker(_emptyInvoker()), _storage() {
+        static_assert(BufferSize >= sizeof(void *) && BufferSize >= sizeof(Function),
+                      "Internal Buffer has to at least hold a pointer!");
+        static_assert(
+            std::is_trivially_destructible<InplaceCallback<BufferSize, R, ArgTs...>>::value,
+            "Callback has to be trivially destructible!");
+#ifdef CONFIG_CALLBACK_NO_COMPARE_BASE
+        static_assert(std::is_trivially_copyable<InplaceCallback<BufferSize, R, ArgTs...>>::value,
+                      "Callback has to be trivially copyable!");
+        static_assert(std::is_standard_layout<InplaceCallback<BufferSize, R, ArgTs...>>::value,
+                      "Callback has to be standard layout!");
+        static_assert(sizeof(InplaceCallback<BufferSize, R, ArgTs...>) ==
+                          (sizeof(Invoker) + BufferSize + alignof(Invoker) - 1) / alignof(Invoker) *
+                              alignof(Invoker),
+                      "Callback has to only consist of its invoker and buffer!");
+#endif
     }
 
     /**
-     * @brief Construct a Callback using a method of an Instance of an Class
+     * @brief Copying (or moving) a Callback copies its invoker and the Bytes of its buffer, which
+     * never throws. See CallbackIsTriviallyRelocatable.
      *
-     * @tparam T
+     */
+    constexpr InplaceCallback(const InplaceCallback<BufferSize, R, ArgTs...> &) noexcept = default;
+    constexpr InplaceCallback(InplaceCallback<BufferSize, R, ArgTs...> &&) noexcept = default;
+    InplaceCallback<BufferSize, R, ArgTs...> &operator=(
+        const InplaceCallback<BufferSize, R, ArgTs...> &) noexcept = default;
+    InplaceCallback<BufferSize, R, ArgTs...> &operator=(
+        InplaceCallback<BufferSize, R, ArgTs...> &&) noexcept = default;
+
+    /**
+     * @brief Construct a Callback using a Function (-pointer). Can be used at compile time, e.g.
+     * to place a table of Callbacks in read-only memory.
+     *
+     * @param func Function to be called on call(), nullptr results in an empty Callback. A
+     * noexcept Callback only accepts noexcept Functions (C++17).
+     */
+    constexpr InplaceCallback(const Function func)
+        : _invoker(func != nullptr ? &FunctionCaller::invoke : _emptyInvoker()), _storage(func) {}
+
+#ifdef __cpp_noexcept_function_type
+    /**
+     * @brief Construct a Callback which may throw using a noexcept Function. It is called through
+     * the caller of the noexcept Callback, so it points to the same destination as a converted
+     * noexcept Callback to the Function (see pointToSame()).
+     *
+     * @param func Function to be called on call(), nullptr results in an empty Callback
+     */
+    template <typename N = R, typename = typename std::enable_if<!CallbackReturn<N>::value>::type>
+    constexpr InplaceCallback(Return (*const func)(ArgTs...) noexcept)
+        : _invoker(func != nullptr ? &NoexceptCallback::FunctionCaller::invoke : _emptyInvoker()),
+          _storage((Function)func) {}
+#endif
+
+    /**
+     * @brief Construct a Callback using a method of an Instance of an Class. The Method may be
+     * const, volatile, noexcept and &-qualified, as long as it can be called on obj.
+     *
+     * @tparam T Type of the Object, including its const / volatile qualifiers
+     * @tparam M Type of the Method (-pointer)
      * @param obj The Instance of the Object the Method should be called on
      * @param method The Method (-pointer) to the method of the Class which should be called
      */
-    template <typename T>
-    Callback(T *const obj, R (T::*const method)(ArgTs... args)) : _callbackSet(true) {
-        _checkSizeEqual<MethodCaller<T>, CALLBACK_INTERNAL_BUFFER_SIZE>();
+    template <typename T, typename M,
+              typename = typename std::enable_if<
+                  isNoexcept ? CallbackIsMethodInvocable<T, M, Return, ArgTs...>::nothrow
+                             : CallbackIsMethodInvocable<T, M, Return, ArgTs...>::value>::type>
+    InplaceCallback(T *const obj, const M method) : _invoker(_emptyInvoker()), _storage() {
+        _checkSizeFit<MethodCaller<T, M>, BufferSize>();
 
         // Special Case: Check for nullptr (normally only interesting for fuction, but whatever)
         if (obj == nullptr || method == nullptr) {
-            _callbackSet = false;
             return;
         }
 
         // Construct the MethodCaller in the internal buffer
-        new (_buffer) MethodCaller<T>(obj, method);
+        constexpr bool nothrow = CallbackIsMethodInvocable<T, M, Return, ArgTs...>::nothrow;
+        using Caller = typename CallerHost<nothrow>::template MethodCaller<T, M>;
+        new (_storage.raw) Caller(obj, method);
+        _invoker = &Caller::invoke;
+    }
+
+    /**
+     * @brief Construct a Callback using a Functor (e.g. a Lambda). A copy of the Functor is stored
+     * in the internal buffer, so it has to be trivially copyable and fit into the buffer.
+     *
+     * @tparam F
+     * @param functor The Functor to be called on call(), has to be callable as const
+     */
+    template <typename F,
+              typename = typename std::enable_if<
+                  std::is_class<F>::value &&
+                  !std::is_base_of<InplaceCallback<BufferSize, R, ArgTs...>, F>::value &&
+                  !std::is_base_of<InplaceCallback<BufferSize, CallbackNoexcept<Return>, ArgTs...>,
+                                   F>::value &&
+                  (isNoexcept ? CallbackIsInvocable<F, Return, ArgTs...>::nothrow
+                              : CallbackIsInvocable<F, Return, ArgTs...>::value)>::type>
+    InplaceCallback(const F &functor) : _invoker(_emptyInvoker()), _storage() {
+        _checkSizeFit<F, BufferSize>();
+        static_assert(alignof(F) <= alignof(void *), "Functor alignment is too big!");
+        static_assert(std::is_trivially_copyable<F>::value,
+                      "Functor has to be trivially copyable!");
+        static_assert(std::is_trivially_destructible<F>::value,
+                      "Functor has to be trivially destructible!");
+
+        // Construct a copy of the Functor in the internal buffer
+        new (_storage.raw) F(functor);
+        _invoker = &CallerHost<CallbackIsInvocable<F, Return, ArgTs...>::nothrow>::template
+                       FunctorCaller<F>::invoke;
     }
 
     /**
-     * @brief Call the Callback
+     * @brief Convert a noexcept Callback into one which may throw, pointing to the same destination
+     * without another indirection. It keeps the caller of the noexcept Callback, which a Callback
+     * constructed from a noexcept Function, Method or Functor uses as well, so both compare equal
+     * (see pointToSame()).
      *
-     * @return R
+     * @param callback
      */
-    R call(ArgTs... args) const { return _call<R, ArgTs...>(args...); }
+    template <typename N = R, typename = typename std::enable_if<!CallbackReturn<N>::value>::type>
+    InplaceCallback(
+        const InplaceCallback<BufferSize, CallbackNoexcept<Return>, ArgTs...> &callback) noexcept
+        : _invoker(callback.isCallbackSet() ? callback._invoker : _emptyInvoker()), _storage() {
+        memcpy(_storage.raw, callback._storage.raw, BufferSize);
+    }
+
+    /**
+     * @brief Create a Callback to a Function known at compile time. The Function is part of the
+     * Invoker, so nothing is stored and the call can be inlined into the Invoker.
+     *
+     * @tparam Func Function to be called on call()
+     * @return InplaceCallback<BufferSize, R, ArgTs...>
+     */
+    template <Function Func>
+    static constexpr InplaceCallback<BufferSize, R, ArgTs...> bind() {
+        return InplaceCallback<BufferSize, R, ArgTs...>(
+            Func != nullptr ? &StaticFunctionCaller<Func>::invoke : _emptyInvoker(), Storage());
+    }
+
+    /**
+     * @brief Create a Callback to a Method known at compile time. Only the Object is stored, the
+     * Method is part of the Invoker and can be inlined into it.
+     *
+     * @tparam T
+     * @tparam Method The Method (-pointer) to the method of the Class which should be called
+     * @param obj The Instance of the Object the Method should be called on
+     * @return InplaceCallback<BufferSize, R, ArgTs...>
+     */
+    template <typename T, Return (T::*Method)(ArgTs...)>
+    static constexpr InplaceCallback<BufferSize, R, ArgTs...> bind(T *const obj) {
+        return _bindMethod<T, Return (T::*)(ArgTs...), Method>(obj);
+    }
+
+    /**
+     * @brief Same as bind<T, Method>(obj) for a const Method
+     *
+     * @tparam T
+     * @tparam Method The Method (-pointer) to the method of the Class which should be called
+     * @param obj The Instance of the Object the Method should be called on
+     * @return InplaceCallback<BufferSize, R, ArgTs...>
+     */
+    template <typename T, Return (T::*Method)(ArgTs...) const>
+    static constexpr InplaceCallback<BufferSize, R, ArgTs...> bind(const T *const obj) {
+        return _bindMethod<const T, Return (T::*)(ArgTs...) const, Method>(obj);
+    }
+
+#ifdef __cpp_nontype_template_parameter_auto
+    /**
+     * @brief Shorthand for bind<T, Method>(obj), deducing T from the Object (C++17). Accepts any
+     * Method which can be called on obj, including volatile, noexcept and &-qualified ones.
+     *
+     * Usage: Callback<void, int>::bind<&Driver::onIrq>(&driver)
+     *
+     * @tparam Method The Method (-pointer) to the method of the Class which should be called
+     * @tparam T
+     * @param obj The Instance of the Object the Method should be called on
+     * @return InplaceCallback<BufferSize, R, ArgTs...>
+     */
+    template <auto Method, typename T>
+    static constexpr InplaceCallback<BufferSize, R, ArgTs...> bind(T *const obj) {
+        return _bindMethod<T, decltype(Method), Method>(obj);
+    }
+#endif
+
+    /**
+     * @brief Call the Callback. The values are forwarded as references to the destination, so a
+     * by-value Argument is only constructed once, see CallbackForwardType.
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param values
+     * @return Return
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    Return call(Us &&...values) const
+        noexcept(isNoexcept && CallbackAll<std::is_nothrow_constructible<
+                                   CallbackForwardType<ArgTs>, Us &&>::value...>::value) {
+        return _call<Return>(std::forward<Us>(values)...);
+    }
 
     /**
      * @brief Shorthand for call()
      *
-     * @param args
-     * @return R
+     * @tparam Us Have to be convertible to ArgTs
+     * @param values
+     * @return Return
      */
-    inline R operator()(ArgTs... args) const { return call(args...); }
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline Return operator()(Us &&...values) const
+        noexcept(isNoexcept && CallbackAll<std::is_nothrow_constructible<
+                                   CallbackForwardType<ArgTs>, Us &&>::value...>::value) {
+        return _call<Return>(std::forward<Us>(values)...);
+    }
+
+    /**
+     * @brief Bind the leading Arguments to fixed values, e.g. a channel id:
+     * callback(&handler, &Handler::onData).bindFront(3)
+     *
+     * The returned Callback stores this Callback together with copies of the values in its own
+     * buffer, no dynamic memory is used. Its buffer is just big enough, use
+     * bindFront<ResultSize>() to get a buffer of a chosen size instead. The values are converted
+     * to (the decayed) leading ArgTs and have to be trivially copyable. Each call passes copies of
+     * them, so non-const reference Arguments can not be bound.
+     *
+     * @tparam BoundTs
+     * @param values Values of the leading Arguments
+     * @return InplaceCallback<Size, R, Remaining ArgTs...>
+     */
+    template <typename... BoundTs>
+    auto bindFront(BoundTs &&...values) const {
+        return bindFront<sizeof(BoundCaller<sizeof...(BoundTs)>)>(std::forward<BoundTs>(values)...);
+    }
+
+    /**
+     * @brief Same as bindFront(values...) with a buffer of ResultSize, checked at compile time
+     *
+     * @tparam ResultSize Buffer size of the returned Callback
+     * @tparam BoundTs
+     * @param values Values of the leading Arguments
+     * @return InplaceCallback<ResultSize, R, Remaining ArgTs...>
+     */
+    template <std::size_t ResultSize, typename... BoundTs>
+    auto bindFront(BoundTs &&...values) const {
+        using Caller = BoundCaller<sizeof...(BoundTs)>;
+        static_assert(sizeof...(BoundTs) <= sizeof...(ArgTs), "Too many Arguments to bind!");
+        _checkSizeFit<Caller, ResultSize>();
+        static_assert(alignof(Caller) <= alignof(void *), "Bound value alignment is too big!");
+        static_assert(std::is_trivially_copyable<Caller>::value,
+                      "Bound values have to be trivially copyable!");
+
+        typename Caller::template Result<ResultSize> result;
+
+        if (isCallbackSet()) {
+            new (result._storage.raw) Caller(*this, std::forward<BoundTs>(values)...);
+            result._invoker = &Caller::invoke;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Get a Callback of the same signature posting each call to the mailbox of the thread
+     * or core owning the destination, which calls it on its next drain() (see
+     * callback_marshal.hpp)
+     *
+     * The returned Callback holds the mailbox and this Callback, so its buffer is two pointers
+     * bigger. It is therefore another InplaceCallback type and can not be stored where a
+     * Callback of this buffer size is expected (e.g. a default CallbackList, CallbackRegistry or
+     * Callback member). Use on<ResultSize>() to match the buffer of such a container, or bindOn()
+     * for a Method known at compile time, which fits the default buffer. A call returns at once
+     * with Return() and is dropped if the mailbox is full (running CALLBACK_MARSHAL_DROPPED()),
+     * use MarshalledCallback to get the result or to know if it was queued.
+     *
+     * Usage: InplaceCallback<48, void, int> onDriver = callback.on<48>(driverMailbox);
+     *
+     * @tparam Mailbox
+     * @param mailbox
+     * @return InplaceCallback<BufferSize + 2 pointers, R, ArgTs...>
+     */
+    template <typename Mailbox>
+    auto on(Mailbox &mailbox) const {
+        return on<sizeof(MarshalCaller<Mailbox>)>(mailbox);
+    }
+
+    /**
+     * @brief Same as on(mailbox) with a buffer of ResultSize, checked at compile time
+     *
+     * @tparam ResultSize Buffer size of the returned Callback
+     * @tparam Mailbox
+     * @param mailbox
+     * @return InplaceCallback<ResultSize, R, ArgTs...>
+     */
+    template <std::size_t ResultSize, typename Mailbox>
+    InplaceCallback<ResultSize, R, ArgTs...> on(Mailbox &mailbox) const {
+        using Caller = MarshalCaller<Mailbox>;
+        _checkSizeFit<Caller, ResultSize>();
+        _checkMarshalReturn();
+
+        InplaceCallback<ResultSize, R, ArgTs...> result;
+
+        if (isCallbackSet()) {
+            new (result._storage.raw) Caller(mailbox, _invoker, _storage);
+            result._invoker = &Caller::invoke;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Bind a Method known at compile time, called by the owner of a mailbox (see on()).
+     * Only the Object and the mailbox are stored, so it fits any buffer of two pointers and is
+     * the way to hand a marshalled destination to a default CallbackList, CallbackRegistry or
+     * Callback member.
+     *
+     * Usage: auto cb = Callback<void, int>::bindOn<Driver, &Driver::onData>(&driver, box);
+     *
+     * @tparam T
+     * @tparam Method
+     * @tparam Mailbox
+     * @param obj
+     * @param mailbox
+     * @return InplaceCallback<BufferSize, R, ArgTs...>
+     */
+    template <typename T, Return (T::*Method)(ArgTs...), typename Mailbox>
+    static InplaceCallback<BufferSize, R, ArgTs...> bindOn(T *const obj, Mailbox &mailbox) {
+        return _bindMethodOn<T, Return (T::*)(ArgTs...), Method>(obj, mailbox);
+    }
+
+    template <typename T, Return (T::*Method)(ArgTs...) const, typename Mailbox>
+    static InplaceCallback<BufferSize, R, ArgTs...> bindOn(const T *const obj, Mailbox &mailbox) {
+        return _bindMethodOn<const T, Return (T::*)(ArgTs...) const, Method>(obj, mailbox);
+    }
+
+#ifdef __cpp_nontype_template_parameter_auto
+    /**
+     * @brief Shorthand for bindOn<T, Method>(obj, mailbox), deducing T from the Object (C++17)
+     *
+     * Usage: auto cb = Callback<void, int>::bindOn<&Driver::onData>(&driver, box);
+     *
+     * @tparam Method
+     * @tparam T
+     * @tparam Mailbox
+     * @param obj
+     * @param mailbox
+     * @return InplaceCallback<BufferSize, R, ArgTs...>
+     */
+    template <auto Method, typename T, typename Mailbox>
+    static InplaceCallback<BufferSize, R, ArgTs...> bindOn(T *const obj, Mailbox &mailbox) {
+        return _bindMethodOn<T, decltype(Method), Method>(obj, mailbox);
+    }
+#endif
 
     /**
      * @brief Check if the callback was set
@@ -119,42 +746,103 @@ class Callback : public CallbackCompare {
      * @return true
      * @return false
      */
-    inline bool isCallbackSet() const override { return _callbackSet; }
+#ifdef CONFIG_CALLBACK_NO_COMPARE_BASE
+    inline bool isCallbackSet() const { return _invoker != _emptyInvoker(); }
+#else
+    inline bool isCallbackSet() const override { return _invoker != _emptyInvoker(); }
+#endif
 
 #ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
     /**
      * @brief Check if this unique Callback is pointing to the same destination as another unique
      * Callback.
      *
+     * The same invoker means the same caller type, so comparing the bound data is enough. A
+     * Callback converted from a noexcept Callback equals one constructed directly from the same
+     * Function, Method or Functor, as nothrow destinations always use the callers of the noexcept
+     * Callback. Only the results of bind<Func>() and bind<T, Method>() (whose template parameter
+     * drops noexcept), bindFront() and on() keep the caller of their own type.
+     *
      * @param other
      * @return true
      * @return false
      */
-    bool pointToSame(const Callback<R, ArgTs...> &other) const {
-        if (!_callbackSet) {
-            if (!other._callbackSet) {
-                return true;
-            }
-        } else {
-            // -> Check if the caller behind is the same
-            if (other._callbackSet) {
-                return ((const InternalCallable *)_buffer)
-                    ->tryCompare(((const InternalCallable *)other._buffer));
-            }
+    bool pointToSame(const InplaceCallback<BufferSize, R, ArgTs...> &other) const {
+        if (_invoker != other._invoker) {
+            return false;
         }
 
-        return false;
+        if (!isCallbackSet()) {
+            return true;
+        }
+
+        return memcmp(&_storage, &other._storage, BufferSize) == 0;
+    }
+
+    /**
+     * @brief Strict weak ordering by the destination (invoker, then bound data), consistent with
+     * pointToSame(). Allows sorted containers and binary search of Callbacks.
+     *
+     * @param other
+     * @return true
+     * @return false
+     */
+    bool pointsBefore(const InplaceCallback<BufferSize, R, ArgTs...> &other) const {
+        const uintptr_t invoker = _invokerAddress();
+        const uintptr_t otherInvoker = other._invokerAddress();
+
+        if (invoker != otherInvoker) {
+            return invoker < otherInvoker;
+        }
+
+        if (!isCallbackSet()) {
+            return false;
+        }
+
+        return memcmp(&_storage, &other._storage, BufferSize) < 0;
     }
 
+    /**
+     * @brief Hash of the destination, consistent with pointToSame(). Used by std::hash.
+     *
+     * @return std::size_t
+     */
+    std::size_t hash() const {
+        std::size_t hash = (std::size_t)_invokerAddress();
+
+        if (!isCallbackSet()) {
+            return hash;
+        }
+
+        const uint8_t *const bytes = (const uint8_t *)&_storage;
+
+        for (std::size_t offset = 0; offset < BufferSize; offset += sizeof(std::size_t)) {
+            std::size_t word = 0;
+            memcpy(&word, bytes + offset,
+                   BufferSize - offset < sizeof(std::size_t) ? BufferSize - offset
+                                                             : sizeof(std::size_t));
+
+            hash ^= word + (std::size_t)0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        }
+
+        return hash;
+    }
+
+#ifndef CONFIG_CALLBACK_NO_COMPARE_BASE
     bool pointToSame(const CallbackCompare &otherCallable) const override {
         // Check if the Callback Type is exactly the same
-        if (typeid(otherCallable) == typeid(*this)) {
-            return pointToSame((Callback<R, ArgTs...> &)otherCallable);
+        if (otherCallable.callbackType() == callbackType()) {
+            return pointToSame((const InplaceCallback<BufferSize, R, ArgTs...> &)otherCallable);
         }
 
         return false;
     }
 
+    const void *callbackType() const override {
+        return &CallbackTypeTag<InplaceCallback<BufferSize, R, ArgTs...>>::id;
+    }
+#endif
+
     /**
      * @brief Shorthand for pointToSame()
      *
@@ -162,142 +850,502 @@ class Callback : public CallbackCompare {
      * @return true
      * @return false
      */
-    inline bool operator==(const Callback<R, ArgTs...> &other) const { return pointToSame(other); }
+    inline bool operator==(const InplaceCallback<BufferSize, R, ArgTs...> &other) const {
+        return pointToSame(other);
+    }
+    inline bool operator!=(const InplaceCallback<BufferSize, R, ArgTs...> &other) const {
+        return !pointToSame(other);
+    }
+
+    /**
+     * @brief Shorthand for pointsBefore()
+     *
+     * @param other
+     * @return true
+     * @return false
+     */
+    inline bool operator<(const InplaceCallback<BufferSize, R, ArgTs...> &other) const {
+        return pointsBefore(other);
+    }
+#ifndef CONFIG_CALLBACK_NO_COMPARE_BASE
     inline bool operator==(const CallbackCompare &otherCallable) const {
         return pointToSame(otherCallable);
     }
+#endif
 #endif
 
    private:
-    class InternalCallable;
+    template <std::size_t, typename, typename...>
+    friend class InplaceCallback;
+
+    /**
+     * @brief Trampoline called with the internal buffer, knows the type of the caller behind.
+     * noexcept for noexcept Callbacks, so calling it needs no landing pad.
+     *
+     */
+#ifdef __cpp_noexcept_function_type
+    using Invoker = Return (*)(const void *caller,
+                               CallbackForwardType<ArgTs>... args) noexcept(isNoexcept);
+#else
+    using Invoker = Return (*)(const void *caller, CallbackForwardType<ArgTs>... args);
+#endif
+
+    using NoexceptCallback = InplaceCallback<BufferSize, CallbackNoexcept<Return>, ArgTs...>;
+
+    /**
+     * @brief Class whose callers are used for a destination. Nothrow destinations are always
+     * called through the callers of the noexcept Callback, so the invoker (and with it
+     * pointToSame(), pointsBefore() and hash()) does not depend on the noexcept flag.
+     *
+     */
+    template <bool Nothrow>
+    using CallerHost = typename std::conditional<Nothrow, NoexceptCallback,
+                                                 InplaceCallback<BufferSize, R, ArgTs...>>::type;
+
+#ifdef CONFIG_CALLBACK_NULL_INVOKER
+    class NullCaller;
+#endif
+
     class FunctionCaller;
 
-    template <typename T>
+    template <typename T, typename M>
     class MethodCaller;
 
+    template <Function Func>
+    class StaticFunctionCaller;
+
+    template <typename T, typename M, M Method>
+    class StaticMethodCaller;
+
+    template <typename F>
+    class FunctorCaller;
+
+    // Defined in callback_marshal.hpp
+    template <typename Mailbox>
+    class MarshalCaller;
+
+    template <typename T, typename M, M Method, typename Mailbox>
+    class StaticMarshalCaller;
+
+    template <std::size_t Count,
+              typename BoundIndices = std::make_index_sequence<Count>,
+              typename RemainingIndices = std::make_index_sequence<
+                  Count <= sizeof...(ArgTs) ? sizeof...(ArgTs) - Count : 0>>
+    class BoundCaller;
+
+    /**
+     * @brief The internal buffer. Functions and Objects of compile time bound Methods are stored
+     * as a (padded) member, so a Callback to them can be constructed at compile time. Everything
+     * else is constructed into the raw Bytes.
+     *
+     */
+    union Storage {
+        constexpr Storage() : raw{} {}
+        constexpr Storage(const Function func) : function(func) {}
+        constexpr Storage(void *const obj) : object(obj) {}
+
+        uint8_t raw[BufferSize];
+        CallbackPaddedValue<Function, BufferSize - sizeof(Function)> function;
+        CallbackPaddedValue<void *, BufferSize - sizeof(void *)> object;
+    };
+
     // Member Variables
-    bool _callbackSet;
-    uint8_t _buffer[CALLBACK_INTERNAL_BUFFER_SIZE]{};
+    Invoker _invoker;
+    Storage _storage;
+
+    constexpr InplaceCallback(const Invoker invoker, const Storage &storage)
+        : _invoker(invoker), _storage(storage) {}
+
+    template <typename T, typename M, M Method>
+    static constexpr InplaceCallback<BufferSize, R, ArgTs...> _bindMethod(T *const obj) {
+        static_assert(isNoexcept ? CallbackIsMethodInvocable<T, M, Return, ArgTs...>::nothrow
+                                 : CallbackIsMethodInvocable<T, M, Return, ArgTs...>::value,
+                      "Method can not be called on the Object with the Arguments of the Callback!");
+
+        return InplaceCallback<BufferSize, R, ArgTs...>(
+            obj != nullptr && Method != nullptr
+                ? &CallerHost<CallbackIsMethodInvocable<T, M, Return, ArgTs...>::nothrow>::
+                      template StaticMethodCaller<T, M, Method>::invoke
+                : _emptyInvoker(),
+            Storage((void *)obj));
+    }
+
+#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
+    // Function pointers can not be ordered directly
+    inline uintptr_t _invokerAddress() const {
+        uintptr_t address = 0;
+        memcpy(&address, &_invoker, sizeof(_invoker) < sizeof(address) ? sizeof(_invoker)
+                                                                         : sizeof(address));
+        return address;
+    }
+#endif
+
+    /**
+     * @brief Invoker of an empty Callback. With CONFIG_CALLBACK_NULL_INVOKER it is the shared
+     * NullCaller, so calling never has to check for it.
+     *
+     * @return constexpr Invoker
+     */
+    static constexpr Invoker _emptyInvoker() {
+#ifdef CONFIG_CALLBACK_NULL_INVOKER
+        return &NullCaller::invoke;
+#else
+        return nullptr;
+#endif
+    }
 
-    template <typename RN, typename... ArgTsN>
+#ifdef CONFIG_CALLBACK_NULL_INVOKER
+    template <typename RN>
+    inline RN _call(CallbackForwardType<ArgTs>... args) const noexcept(isNoexcept) {
+        return _invoker(&_storage, callbackForward<ArgTs>(args)...);
+    }
+#else
+    template <typename RN>
     inline typename std::enable_if<!std::is_same<RN, void>::value, RN>::type _call(
-        ArgTsN... args) const {
-        if (_callbackSet) {
-            return ((InternalCallable *)_buffer)->call(args...);
+        CallbackForwardType<ArgTs>... args) const noexcept(isNoexcept) {
+        if (_invoker != nullptr) {
+            return _invoker(&_storage, callbackForward<ArgTs>(args)...);
         }
 
         return (RN)0;
     }
 
-    template <typename RN, typename... ArgTsN>
+    template <typename RN>
     inline typename std::enable_if<std::is_same<RN, void>::value, RN>::type _call(
-        ArgTsN... args) const {
-        if (_callbackSet) {
-            ((InternalCallable *)_buffer)->call(args...);
+        CallbackForwardType<ArgTs>... args) const noexcept(isNoexcept) {
+        if (_invoker != nullptr) {
+            _invoker(&_storage, callbackForward<ArgTs>(args)...);
         }
     }
-
-    template <typename ToCheck, std::size_t ExpectedSize, std::size_t RealSize = sizeof(ToCheck)>
-    constexpr void _checkSizeEqual() {
-        static_assert(ExpectedSize >= RealSize, "Internal Buffer is too small!");
-        static_assert(ExpectedSize == RealSize, "Internal Buffer is too big!");
-    }
+#endif
 
     template <typename ToCheck, std::size_t MaxSize, std::size_t RealSize = sizeof(ToCheck)>
-    constexpr void _checkSizeFit() {
+    static constexpr void _checkSizeFit() {
         static_assert(MaxSize >= RealSize, "Internal Buffer is too small!");
     }
 
+    static constexpr void _checkMarshalReturn() {
+        static_assert(std::is_void<Return>::value || std::is_default_constructible<Return>::value,
+                      "Marshalled calls return Return(), which has to be default constructible!");
+    }
+
+    template <typename T, typename M, M Method, typename Mailbox>
+    static InplaceCallback<BufferSize, R, ArgTs...> _bindMethodOn(T *const obj, Mailbox &mailbox) {
+        using Caller = StaticMarshalCaller<T, M, Method, Mailbox>;
+        static_assert(isNoexcept ? CallbackIsMethodInvocable<T, M, Return, ArgTs...>::nothrow
+                                 : CallbackIsMethodInvocable<T, M, Return, ArgTs...>::value,
+                      "Method can not be called on the Object with the Arguments of the Callback!");
+        _checkSizeFit<Caller, BufferSize>();
+        _checkMarshalReturn();
+
+        InplaceCallback<BufferSize, R, ArgTs...> result;
+
+        if (obj != nullptr && Method != nullptr) {
+            new (result._storage.raw) Caller(obj, mailbox);
+            result._invoker = &Caller::invoke;
+        }
+
+        return result;
+    }
+
+#ifdef CONFIG_CALLBACK_NULL_INVOKER
     /**
-     * @brief InternalCallable Interface
+     * @brief Caller of every empty Callback of this type, does nothing and returns Return{}
      *
-     * @tparam R Return Value of the assigned callback function
      */
+    class NullCaller {
+       public:
+        static Return invoke(const void *, CallbackForwardType<ArgTs>...) noexcept {
+            return Return();
+        }
+    };
+#endif
 
-    class InternalCallable {
+    /**
+     * @brief Specific caller for a Function, the Function is stored in Storage::function.
+     * invoke() is stored as the Invoker of the Callback.
+     *
+     */
+    class FunctionCaller {
        public:
-        virtual R call(ArgTs... args) const = 0;
+        static Return invoke(const void *caller,
+                             CallbackForwardType<ArgTs>... args) noexcept(isNoexcept) {
+#ifdef CONFIG_CALLBACK_INSTRUMENT
+            const CallbackInstrumentScope scope(&FunctionCaller::invoke,
+                                                &((const Storage *)caller)->function.value,
+                                                sizeof(Function));
+#endif
+            return (*((const Storage *)caller)->function.value)(callbackForward<ArgTs>(args)...);
+        }
+    };
 
-#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
-        /**
-         * @brief Use this function with caution! Only FunctionCaller can be compared to each other
-         * and only MethodCaller can be compared. Cross-Type comparrisson is not allowed ->
-         * undefined. behaviour
-         *
-         * @return callable_type_t
-         */
-        virtual bool tryCompare(const InternalCallable *other) const = 0;
+    template <typename T, typename M>
+    class MethodCaller {
+       public:
+        constexpr MethodCaller(T *const obj, const M method) : _obj(obj), _method(method) {}
+
+        static Return invoke(const void *caller,
+                             CallbackForwardType<ArgTs>... args) noexcept(isNoexcept) {
+            const MethodCaller<T, M> *methodCaller = (const MethodCaller<T, M> *)caller;
+#ifdef CONFIG_CALLBACK_INSTRUMENT
+            const CallbackInstrumentScope scope(&MethodCaller<T, M>::invoke, methodCaller,
+                                                sizeof(MethodCaller<T, M>));
+#endif
+            return static_cast<Return>(
+                (*methodCaller->_obj.*methodCaller->_method)(callbackForward<ArgTs>(args)...));
+        }
+
+       private:
+        T *const _obj;
+        const M _method;
+    };
+
+    /**
+     * @brief Caller for a Function known at compile time, holds no data at all
+     *
+     */
+    template <Function Func>
+    class StaticFunctionCaller {
+       public:
+        static Return invoke(const void *,
+                             CallbackForwardType<ArgTs>... args) noexcept(isNoexcept) {
+#ifdef CONFIG_CALLBACK_INSTRUMENT
+            const CallbackInstrumentScope scope(&StaticFunctionCaller<Func>::invoke);
 #endif
+            return Func(callbackForward<ArgTs>(args)...);
+        }
     };
 
     /**
-     * @brief Specific caller using the InternalCallable Interface
+     * @brief Caller for a Method known at compile time, the Object is stored in Storage::object
      *
      */
-    class FunctionCaller : public InternalCallable {
+    template <typename T, typename M, M Method>
+    class StaticMethodCaller {
        public:
-        constexpr FunctionCaller(R (*const func)(ArgTs...)) : _func(func) {}
+        static Return invoke(const void *caller,
+                             CallbackForwardType<ArgTs>... args) noexcept(isNoexcept) {
+#ifdef CONFIG_CALLBACK_INSTRUMENT
+            const CallbackInstrumentScope scope(&StaticMethodCaller<T, M, Method>::invoke,
+                                                &((const Storage *)caller)->object.value,
+                                                sizeof(void *));
+#endif
+            return static_cast<Return>((*(T *)((const Storage *)caller)->object.value.*Method)(
+                callbackForward<ArgTs>(args)...));
+        }
+    };
 
-        R call(ArgTs... args) const { return (*_func)(args...); }
+    /**
+     * @brief Caller for a Functor, the buffer holds the Functor itself
+     *
+     */
+    template <typename F>
+    class FunctorCaller {
+       public:
+        static Return invoke(const void *caller,
+                             CallbackForwardType<ArgTs>... args) noexcept(isNoexcept) {
+#ifdef CONFIG_CALLBACK_INSTRUMENT
+            const CallbackInstrumentScope scope(&FunctorCaller<F>::invoke);
+#endif
+            return static_cast<Return>((*(const F *)caller)(callbackForward<ArgTs>(args)...));
+        }
+    };
 
-#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
-        bool tryCompare(const InternalCallable *otherPtr) const {
-            if (otherPtr != nullptr) {
-                if (typeid(*otherPtr) == typeid(*this)) {
-                    FunctionCaller *otherFunc = (FunctionCaller *)otherPtr;
+    /**
+     * @brief Caller of a Callback returned by bindFront(). Holds the invoker and buffer of the
+     * source Callback and the bound values, which are passed (as copies) in front of the
+     * remaining Arguments.
+     *
+     */
+    template <std::size_t Count, std::size_t... BoundIndices, std::size_t... RemainingIndices>
+    class BoundCaller<Count, std::index_sequence<BoundIndices...>,
+                      std::index_sequence<RemainingIndices...>> {
+        template <std::size_t Index>
+        using Bound = typename std::decay<typename CallbackTypeAt<Index, ArgTs...>::Type>::type;
 
-                    if (otherFunc->_func == _func) {
-                        return true;
-                    }
-                }
-            }
+        template <std::size_t Index>
+        using Remaining = typename CallbackTypeAt<Count + Index, ArgTs...>::Type;
 
-            return false;
+       public:
+        template <std::size_t Size>
+        using Result = InplaceCallback<Size, R, Remaining<RemainingIndices>...>;
+
+        template <typename... BoundTs>
+        BoundCaller(const InplaceCallback<BufferSize, R, ArgTs...> &source, BoundTs &&...values)
+            : _invoker(source._invoker),
+              _storage(source._storage),
+              _values(std::forward<BoundTs>(values)...) {}
+
+        static Return invoke(const void *caller,
+                             CallbackForwardType<Remaining<RemainingIndices>>... args) noexcept(
+            isNoexcept) {
+            const BoundCaller *boundCaller = (const BoundCaller *)caller;
+            return boundCaller->_invoker(
+                &boundCaller->_storage,
+                Bound<BoundIndices>(boundCaller->_values.template get<BoundIndices>())...,
+                callbackForward<Remaining<RemainingIndices>>(args)...);
         }
-#endif
 
        private:
-        constexpr FunctionCaller() {}
-
-        R (*const _func)(ArgTs...);
+        const Invoker _invoker;
+        const Storage _storage;
+        const CallbackValues<std::index_sequence<BoundIndices...>, Bound<BoundIndices>...> _values;
     };
+};
 
-    template <typename T>
-    class MethodCaller : public InternalCallable {
-       public:
-        constexpr MethodCaller(T *const obj, R (T::*const method)(ArgTs...))
-            : _obj(obj), _method(method) {}
+/**
+ * @brief Callback written with a function signature, e.g. InplaceCallback<16, void(int)>. The
+ * same as InplaceCallback<BufferSize, R, ArgTs...>.
+ *
+ * @tparam BufferSize Size of the internal buffer holding the bound data
+ * @tparam R Return type
+ * @tparam ArgTs Optional Arguments
+ */
+template <std::size_t BufferSize, typename R, typename... ArgTs>
+class InplaceCallback<BufferSize, R(ArgTs...)> : public InplaceCallback<BufferSize, R, ArgTs...> {
+    using Base = InplaceCallback<BufferSize, R, ArgTs...>;
 
-        R call(ArgTs... args) const { return (*_obj.*_method)(args...); }
+   public:
+    using Base::Base;
 
-#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
-        bool tryCompare(const InternalCallable *otherCallable) const {
-            if (otherCallable != nullptr) {
-                if (typeid(*otherCallable) == typeid(*this)) {
-                    MethodCaller<T> *otherPtr = (MethodCaller<T> *)otherCallable;
-
-                    if (otherPtr->_obj == _obj) {
-                        if (otherPtr->_method == _method) {
-                            return true;
-                        }
-                    }
-                }
-            }
+    constexpr InplaceCallback() = default;
+    constexpr InplaceCallback(const Base &callback) noexcept : Base(callback) {}
+};
 
-            return false;
-        }
+#ifdef __cpp_noexcept_function_type
+/**
+ * @brief Callback with a noexcept signature, e.g. Callback<void(int) noexcept> (C++17). Only
+ * noexcept Functions, Methods and Functors can be bound and call() is noexcept as well, so no
+ * unwinding tables or landing pads are needed where it is called.
+ *
+ * @tparam BufferSize Size of the internal buffer holding the bound data
+ * @tparam R Return type
+ * @tparam ArgTs Optional Arguments
+ */
+template <std::size_t BufferSize, typename R, typename... ArgTs>
+class InplaceCallback<BufferSize, R(ArgTs...) noexcept>
+    : public InplaceCallback<BufferSize, CallbackNoexcept<R>, ArgTs...> {
+    using Base = InplaceCallback<BufferSize, CallbackNoexcept<R>, ArgTs...>;
+
+   public:
+    using Base::Base;
+
+    constexpr InplaceCallback() = default;
+    constexpr InplaceCallback(const Base &callback) noexcept : Base(callback) {}
+};
 #endif
 
-       private:
-        constexpr MethodCaller() {}
+/**
+ * @brief Callback using the default internal buffer size
+ *
+ * @tparam R Return type
+ * @tparam ArgTs Optional Arguments
+ */
+template <typename R, typename... ArgTs>
+using Callback = InplaceCallback<CALLBACK_INTERNAL_BUFFER_SIZE, R, ArgTs...>;
 
-        T *const _obj;
-        R (T::*const _method)(ArgTs...);
-    };
+#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
+/**
+ * @brief Hash Callbacks by their destination, so they can be used as key of unordered containers
+ *
+ */
+namespace std {
+template <std::size_t BufferSize, typename R, typename... ArgTs>
+struct hash<InplaceCallback<BufferSize, R, ArgTs...>> {
+    inline std::size_t operator()(const InplaceCallback<BufferSize, R, ArgTs...> &callback) const {
+        return callback.hash();
+    }
 };
+}   // namespace std
+#endif
+
+/**
+ * @brief Check if objects of a type can be relocated (moved to another address and the source
+ * forgotten) by copying their Bytes, e.g. with memcpy while growing or compacting a container.
+ *
+ * Every Callback is: it only consists of its invoker and the Bytes of its buffer, the stored
+ * Functors have to be trivially copyable. Even with the CallbackCompare base the vptr only depends
+ * on the type. Specialize this for own types which can be relocated bytewise as well.
+ *
+ * @tparam T
+ */
+template <typename T>
+struct CallbackIsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+template <std::size_t BufferSize, typename R, typename... ArgTs>
+struct CallbackIsTriviallyRelocatable<InplaceCallback<BufferSize, R, ArgTs...>>
+    : std::true_type {};
+
+/**
+ * @brief Relocate count objects from source to destination (may overlap). Afterwards the objects
+ * live at destination and source is raw memory. Trivially relocatable types are moved with a
+ * single memmove, everything else is move constructed and destroyed one by one.
+ *
+ * @tparam T
+ * @param destination Raw memory for count objects
+ * @param source count constructed objects
+ * @param count
+ */
+template <typename T>
+typename std::enable_if<CallbackIsTriviallyRelocatable<T>::value>::type relocateCallbacks(
+    T *destination, T *source, const std::size_t count) {
+    memmove((void *)destination, (const void *)source, count * sizeof(T));
+}
+
+template <typename T>
+typename std::enable_if<!CallbackIsTriviallyRelocatable<T>::value>::type relocateCallbacks(
+    T *destination, T *source, const std::size_t count) {
+    if (destination < source) {
+        for (std::size_t i = 0; i < count; i++) {
+            new (&destination[i]) T(std::move(source[i]));
+            source[i].~T();
+        }
+    } else if (destination > source) {
+        for (std::size_t i = count; i > 0; i--) {
+            new (&destination[i - 1]) T(std::move(source[i - 1]));
+            source[i - 1].~T();
+        }
+    }
+}
 
 // -------------- Functions for easier and faster access to a Callback
 
+/**
+ * @brief The Callback type matching a Method (-pointer), for all const / volatile / & qualified and
+ * noexcept Methods
+ *
+ * @tparam M Method (-pointer) type
+ */
+template <typename M>
+struct CallbackMethodTraits {};
+
+#define CALLBACK_METHOD_TRAITS(QUALIFIERS)                          \
+    template <typename T, typename R, typename... ArgTs>            \
+    struct CallbackMethodTraits<R (T::*)(ArgTs...) QUALIFIERS> {    \
+        using Type = Callback<R, ArgTs...>;                         \
+    };
+
+CALLBACK_METHOD_TRAITS()
+CALLBACK_METHOD_TRAITS(const)
+CALLBACK_METHOD_TRAITS(volatile)
+CALLBACK_METHOD_TRAITS(const volatile)
+CALLBACK_METHOD_TRAITS(&)
+CALLBACK_METHOD_TRAITS(const &)
+CALLBACK_METHOD_TRAITS(volatile &)
+CALLBACK_METHOD_TRAITS(const volatile &)
+#ifdef __cpp_noexcept_function_type
+CALLBACK_METHOD_TRAITS(noexcept)
+CALLBACK_METHOD_TRAITS(const noexcept)
+CALLBACK_METHOD_TRAITS(volatile noexcept)
+CALLBACK_METHOD_TRAITS(const volatile noexcept)
+CALLBACK_METHOD_TRAITS(& noexcept)
+CALLBACK_METHOD_TRAITS(const & noexcept)
+CALLBACK_METHOD_TRAITS(volatile & noexcept)
+CALLBACK_METHOD_TRAITS(const volatile & noexcept)
+#endif
+
+#undef CALLBACK_METHOD_TRAITS
+
 /**
  * @brief Callback for a single function
  *
@@ -314,26 +1362,26 @@ Callback<R, ArgTs...> callback(R (*func)(ArgTs...)) {
  * @brief Callback for an Object's function
  *
  * @tparam T
- * @tparam R
+ * @tparam M Method (-pointer) type, may be const / volatile / & qualified and noexcept
  * @param obj
  * @param method
  * @return Callback<R>
  */
-template <typename T, typename R, typename... ArgTs>
-Callback<R, ArgTs...> callback(T *obj, R (T::*method)(ArgTs...)) {
-    return Callback<R, ArgTs...>(obj, method);
+template <typename T, typename M>
+typename CallbackMethodTraits<M>::Type callback(T *obj, M method) {
+    return typename CallbackMethodTraits<M>::Type(obj, method);
 }
 
 /**
  * @brief Callback for an Object's function
  *
  * @tparam T
- * @tparam R
+ * @tparam M Method (-pointer) type, may be const / volatile / & qualified and noexcept
  * @param obj
  * @param method
  * @return Callback<R>
  */
-template <typename T, typename R, typename... ArgTs>
-Callback<R, ArgTs...> callback(T &obj, R (T::*method)(ArgTs...)) {
-    return Callback<R, ArgTs...>(&obj, method);
+template <typename T, typename M>
+typename CallbackMethodTraits<M>::Type callback(T &obj, M method) {
+    return typename CallbackMethodTraits<M>::Type(&obj, method);
 }
@@ -0,0 +1,207 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Callback slot which can be rebound while it is called, e.g. an interrupt handler
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <utility>
+
+#include "callback.hpp"
+
+/**
+ * @brief Holds a Callback which can be replaced while other contexts load and call it, without
+ * ever seeing a torn Callback
+ *
+ * The Callback is stored twice (double buffered) as words of atomics. A store claims the buffer
+ * which is not published with a CAS on the state word (published index and claim), writes it,
+ * guarded by a sequence counter of the buffer, and then publishes it. A load copies the published
+ * buffer and only retries if that buffer got rewritten meanwhile, which takes two stores
+ * completing during the copy. So an ISR loading the slot never waits for a store it interrupted,
+ * and a store never waits for a load.
+ *
+ * NOTE: No operation takes a lock. A store which finds the unpublished buffer claimed by another
+ * store (which it preempted or which runs on another core) does not wait for it but fails, the
+ * slot keeps the Callback of the other store. Check the result where stores can overlap, e.g. in
+ * an ISR while the main loop stores as well, and store again later if needed. load() and call()
+ * are safe from anywhere.
+ *
+ * @tparam R Return type
+ * @tparam ArgTs Optional Arguments
+ */
+template <typename R, typename... ArgTs>
+class AtomicCallbackSlot {
+   public:
+    using CallbackT = Callback<R, ArgTs...>;
+    using Return = typename CallbackT::Return;
+
+    AtomicCallbackSlot() : _state(0) { _write(0, CallbackT()); }
+
+    AtomicCallbackSlot(const CallbackT &callback) : _state(0) { _write(0, callback); }
+
+    AtomicCallbackSlot(const AtomicCallbackSlot &) = delete;
+    AtomicCallbackSlot &operator=(const AtomicCallbackSlot &) = delete;
+
+    /**
+     * @brief Get a copy of the current Callback
+     *
+     * @return CallbackT
+     */
+    CallbackT load() const {
+        Words words;
+
+        while (true) {
+            const uint8_t index = _state.load(std::memory_order_acquire) & _indexMask;
+            const Buffer &buffer = _buffers[index];
+            const uint32_t sequence = buffer.sequence.load(std::memory_order_acquire);
+
+            // Odd while a store rewrites it, which needs another store published since the load
+            if ((sequence & 1) == 0) {
+                for (std::size_t i = 0; i < _words; i++) {
+                    words[i] = buffer.words[i].load(std::memory_order_relaxed);
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (buffer.sequence.load(std::memory_order_relaxed) == sequence) {
+                    break;
+                }
+            }
+        }
+
+        CallbackT callback;
+        memcpy((void *)&callback, words, sizeof(CallbackT));
+        return callback;
+    }
+
+    /**
+     * @brief Replace the Callback, calls starting afterwards use the new one
+     *
+     * @param callback
+     * @return true
+     * @return false Another store was in progress, the Callback was not stored
+     */
+    bool store(const CallbackT &callback) {
+        uint8_t active;
+
+        if (!_claim(active)) {
+            return false;
+        }
+
+        _write(active ^ 1, callback);
+        _publish(active ^ 1);
+        return true;
+    }
+
+    /**
+     * @brief Replace the Callback and get the one it replaced
+     *
+     * @param callback
+     * @param previous Set to the replaced Callback, only if it was replaced
+     * @return true
+     * @return false Another store was in progress, the Callback was not stored
+     */
+    bool exchange(const CallbackT &callback, CallbackT &previous) {
+        uint8_t active;
+
+        if (!_claim(active)) {
+            return false;
+        }
+
+        previous = load();
+        _write(active ^ 1, callback);
+        _publish(active ^ 1);
+        return true;
+    }
+
+    /**
+     * @brief Call the current Callback. The values are forwarded, so a by-value Argument is only
+     * constructed once, see CallbackForwardType.
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param values
+     * @return Return
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline Return call(Us &&...values) const { return load()(std::forward<Us>(values)...); }
+
+    /**
+     * @brief Shorthand for call()
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param values
+     * @return Return
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline Return operator()(Us &&...values) const {
+        return load()(std::forward<Us>(values)...);
+    }
+
+   private:
+    static constexpr std::size_t _words = (sizeof(CallbackT) + sizeof(uintptr_t) - 1) /
+                                          sizeof(uintptr_t);
+
+    using Words = uintptr_t[_words];
+
+    struct Buffer {
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<uintptr_t> words[_words];
+    };
+
+    // State: index of the published buffer and if a store claimed the other one
+    static constexpr uint8_t _indexMask = 1;
+    static constexpr uint8_t _claimed = 2;
+
+    Buffer _buffers[2];
+    std::atomic<uint8_t> _state;
+
+    void _write(const uint8_t index, const CallbackT &callback) {
+        Words words = {};
+        memcpy(words, (const void *)&callback, sizeof(CallbackT));
+
+        Buffer &buffer = _buffers[index];
+        const uint32_t sequence = buffer.sequence.load(std::memory_order_relaxed);
+        buffer.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < _words; i++) {
+            buffer.words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        buffer.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Claim the unpublished buffer, fails instead of waiting if another store claimed it.
+     * The CAS is only retried if a store was published meanwhile.
+     *
+     * @param active Set to the index of the published buffer
+     * @return true
+     * @return false Another store claimed it
+     */
+    bool _claim(uint8_t &active) {
+        uint8_t state = _state.load(std::memory_order_relaxed);
+
+        do {
+            if ((state & _claimed) != 0) {
+                return false;
+            }
+        } while (!_state.compare_exchange_weak(state, state | _claimed, std::memory_order_acquire,
+                                               std::memory_order_relaxed));
+
+        active = state & _indexMask;
+        return true;
+    }
+
+    // Publish the buffer and release the claim at once
+    inline void _publish(const uint8_t index) { _state.store(index, std::memory_order_release); }
+};
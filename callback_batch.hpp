@@ -0,0 +1,226 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Structure of arrays batch of method Callbacks, for fan-out to many Objects of one type
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include "callback.hpp"
+
+/**
+ * @brief Calls one event on many Objects of the same type, grouped by their Method
+ *
+ * Instead of one Callback (invoker, Object and Method) per target, every group stores its Method
+ * once, followed by a contiguous range of Object pointers in one shared array. emit() resolves the
+ * Method once per group and then runs a tight loop over the Objects, which the compiler can unroll
+ * and the Objects are prefetched in.
+ *
+ * add() and remove() move the Objects of the following groups, emit() stays the fast path. The
+ * Objects are called group by group, so the order they were added in is only kept per group.
+ *
+ * NOTE: Not thread safe, add(), remove() and emit() have to be called from the same context.
+ *
+ * NOTE: Only non-const Methods taking exactly ArgTs can be added (see Method), so every group
+ * calls its Objects through the same Method pointer type. Use a CallbackList for const or
+ * otherwise qualified Methods.
+ *
+ * @tparam T Type of the Objects
+ * @tparam Capacity Maximum amount of Objects, over all groups
+ * @tparam Groups Maximum amount of different Methods
+ * @tparam ArgTs Optional Arguments
+ */
+template <typename T, std::size_t Capacity, std::size_t Groups, typename... ArgTs>
+class CallbackBatch {
+    static_assert(Capacity > 0 && Groups > 0, "Empty batch!");
+
+   public:
+    // The Method of a group, const Methods can not be converted to it
+    using Method = void (T::*)(ArgTs...);
+
+    CallbackBatch() : _groups(0) {}
+
+    CallbackBatch(const CallbackBatch &) = delete;
+    CallbackBatch &operator=(const CallbackBatch &) = delete;
+
+    /**
+     * @brief Add an Object to the group of its Method
+     *
+     * @param obj
+     * @param method
+     * @return true Object was added
+     * @return false No space left, or obj / method are not set
+     */
+    bool add(T *const obj, const Method method) {
+        if (obj == nullptr || method == nullptr || size() >= Capacity) {
+            return false;
+        }
+
+        std::size_t group = _find(method);
+
+        if (group == _groups) {
+            if (_groups >= Groups) {
+                return false;
+            }
+
+            _methods[group] = method;
+            _ends[group] = size();
+            _groups++;
+        }
+
+        // Make room at the end of the group
+        for (std::size_t i = size(); i > _ends[group]; i--) {
+            _objects[i] = _objects[i - 1];
+        }
+
+        _objects[_ends[group]] = obj;
+
+        for (std::size_t i = group; i < _groups; i++) {
+            _ends[i]++;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Remove an Object from the group of a Method, once
+     *
+     * @param obj
+     * @param method
+     * @return true The Object was removed
+     * @return false The Object is not in the group of this Method
+     */
+    bool remove(T *const obj, const Method method) {
+        const std::size_t group = _find(method);
+
+        if (group == _groups) {
+            return false;
+        }
+
+        for (std::size_t i = _begin(group); i < _ends[group]; i++) {
+            if (_objects[i] != obj) {
+                continue;
+            }
+
+            const std::size_t count = size();
+
+            for (std::size_t j = i + 1; j < count; j++) {
+                _objects[j - 1] = _objects[j];
+            }
+
+            for (std::size_t j = group; j < _groups; j++) {
+                _ends[j]--;
+            }
+
+            if (_ends[group] == _begin(group)) {
+                _removeGroup(group);
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Remove all Objects
+     *
+     */
+    inline void clear() { _groups = 0; }
+
+    /**
+     * @brief Call the Method of every group on all of its Objects. The groups are called one
+     * after another, in the order their first Object was added, and the Objects of a group in
+     * the order they were added. So the order is only kept within a group, not across groups:
+     * an Object added to an earlier group is called before all Objects of later groups.
+     *
+     * The Arguments are taken as CallbackForwardType, so a by-value Argument is only constructed
+     * by the parameters of the Methods. Only the last Object gets them forwarded, the others as
+     * lvalues.
+     *
+     * @param args
+     */
+    void emit(CallbackForwardType<ArgTs>... args) const {
+        if (_groups == 0) {
+            return;
+        }
+
+        const std::size_t last = size() - 1;
+        std::size_t i = 0;
+
+        for (std::size_t group = 0; group < _groups; group++) {
+            const Method method = _methods[group];
+            const std::size_t end = group + 1 < _groups ? _ends[group] : last;
+
+            for (; i < end; i++) {
+#ifdef __GNUC__
+                if (i + _prefetchDistance < end) {
+                    __builtin_prefetch(_objects[i + _prefetchDistance]);
+                }
+#endif
+                (_objects[i]->*method)(args...);
+            }
+        }
+
+        (_objects[last]->*_methods[_groups - 1])(callbackForward<ArgTs>(args)...);
+    }
+
+    /**
+     * @brief Shorthand for emit()
+     *
+     * @param args
+     */
+    inline void operator()(CallbackForwardType<ArgTs>... args) const {
+        emit(callbackForward<ArgTs>(args)...);
+    }
+
+    /**
+     * @brief Get the amount of Objects
+     *
+     * @return std::size_t
+     */
+    inline std::size_t size() const { return _groups == 0 ? 0 : _ends[_groups - 1]; }
+
+    /**
+     * @brief Get the amount of different Methods
+     *
+     * @return std::size_t
+     */
+    inline std::size_t groups() const { return _groups; }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+   private:
+    // Objects ahead of the current one which are prefetched
+    static constexpr std::size_t _prefetchDistance = 8;
+
+    T *_objects[Capacity];
+    Method _methods[Groups];
+    std::size_t _ends[Groups];   // One past the last Object of each group
+    std::size_t _groups;
+
+    inline std::size_t _begin(const std::size_t group) const {
+        return group == 0 ? 0 : _ends[group - 1];
+    }
+
+    std::size_t _find(const Method method) const {
+        std::size_t group = 0;
+
+        while (group < _groups && _methods[group] != method) {
+            group++;
+        }
+
+        return group;
+    }
+
+    void _removeGroup(const std::size_t group) {
+        for (std::size_t i = group + 1; i < _groups; i++) {
+            _methods[i - 1] = _methods[i];
+            _ends[i - 1] = _ends[i];
+        }
+
+        _groups--;
+    }
+};
@@ -0,0 +1,224 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief C++20 coroutine adapters: Callbacks resuming coroutines and awaiting Callbacks
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include "callback.hpp"
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+
+#include <stdint.h>
+
+#include <atomic>
+#include <coroutine>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Functor resuming a coroutine, the handle is all it stores
+ *
+ */
+class CallbackResume {
+   public:
+    constexpr CallbackResume(const std::coroutine_handle<> handle) : _handle(handle) {}
+
+    inline void operator()() const { _handle.resume(); }
+
+   private:
+    std::coroutine_handle<> _handle;
+};
+
+/**
+ * @brief Callback resuming a suspended coroutine, e.g. to post it to a CallbackQueue
+ *
+ * @param handle
+ * @return Callback<void>
+ */
+inline Callback<void> resumeCallback(const std::coroutine_handle<> handle) {
+    return Callback<void>(CallbackResume(handle));
+}
+
+/**
+ * @brief What co_await of a CallbackAwaiter results in: nothing, the single Argument or a tuple of
+ * all Arguments
+ *
+ * @tparam ArgTs
+ */
+template <typename... ArgTs>
+struct CallbackAwaitResult {
+    using Values = std::tuple<typename std::decay<ArgTs>::type...>;
+    using Type = Values;
+
+    static inline Type get(Values &values) { return std::move(values); }
+};
+
+template <typename T>
+struct CallbackAwaitResult<T> {
+    using Values = std::tuple<typename std::decay<T>::type>;
+    using Type = typename std::decay<T>::type;
+
+    static inline Type get(Values &values) { return std::move(std::get<0>(values)); }
+};
+
+template <>
+struct CallbackAwaitResult<> {
+    using Values = std::tuple<>;
+    using Type = void;
+
+    static inline Type get(Values &) {}
+};
+
+/**
+ * @brief Awaitable completed by a Callback, delivering its Arguments to the awaiting coroutine
+ *
+ * Usage:
+ *   CallbackAwaiter<int> done;
+ *   driver.read(buffer, done.callback());
+ *   int result = co_await done;
+ *
+ * No dynamic memory is used, the Callback only points to the awaiter. It may fire before the
+ * coroutine awaits it (then co_await does not suspend) and from another thread or an ISR, the
+ * coroutine is then resumed in that context. After co_await the awaiter can be used again.
+ *
+ * @tparam ArgTs Arguments of the completion Callback
+ */
+template <typename... ArgTs>
+class CallbackAwaiter {
+   public:
+    CallbackAwaiter() : _state(_idle) {}
+
+    CallbackAwaiter(const CallbackAwaiter &) = delete;
+    CallbackAwaiter &operator=(const CallbackAwaiter &) = delete;
+
+    ~CallbackAwaiter() {
+        if (_state.load(std::memory_order_acquire) == _completed) {
+            _values()->~Values();
+        }
+    }
+
+    /**
+     * @brief Get the Callback completing this awaiter, call it exactly once per co_await
+     *
+     * @return Callback<void, ArgTs...>
+     */
+    inline Callback<void, ArgTs...> callback() {
+        return Callback<void, ArgTs...>::template bind<CallbackAwaiter<ArgTs...>,
+                                                       &CallbackAwaiter<ArgTs...>::complete>(this);
+    }
+
+    /**
+     * @brief Store the Arguments and resume the coroutine, if it already awaits
+     *
+     * @param args
+     */
+    void complete(ArgTs... args) {
+        new (_storage) Values(std::forward<ArgTs>(args)...);
+
+        if (_state.exchange(_completed, std::memory_order_acq_rel) == _suspended) {
+            _handle.resume();
+        }
+    }
+
+    inline bool await_ready() const noexcept {
+        return _state.load(std::memory_order_acquire) == _completed;
+    }
+
+    inline bool await_suspend(const std::coroutine_handle<> handle) noexcept {
+        _handle = handle;
+        return _suspend();
+    }
+
+    typename CallbackAwaitResult<ArgTs...>::Type await_resume() {
+        Values *const values = _values();
+        _state.store(_idle, std::memory_order_relaxed);
+
+        struct Destroy {
+            Values *values;
+            ~Destroy() { values->~Values(); }
+        } destroy{values};
+
+        return CallbackAwaitResult<ArgTs...>::get(*values);
+    }
+
+   protected:
+    /**
+     * @brief Suspend, unless the Callback already fired
+     *
+     * @return true The coroutine is suspended until the Callback fires
+     * @return false The Callback already fired, continue right away
+     */
+    inline bool _suspend() {
+        uint8_t expected = _idle;
+        return _state.compare_exchange_strong(expected, _suspended, std::memory_order_acq_rel);
+    }
+
+    std::coroutine_handle<> _handle;
+
+   private:
+    using Values = typename CallbackAwaitResult<ArgTs...>::Values;
+
+    static constexpr uint8_t _idle = 0;
+    static constexpr uint8_t _suspended = 1;
+    static constexpr uint8_t _completed = 2;
+
+    std::atomic<uint8_t> _state;
+    alignas(Values) unsigned char _storage[sizeof(Values)];
+
+    inline Values *_values() { return std::launder((Values *)_storage); }
+};
+
+/**
+ * @brief Awaitable which starts an operation with its completion Callback when awaited, see
+ * awaitCallback()
+ *
+ * @tparam Initiator Called with the Callback<void, ArgTs...> to start the operation
+ * @tparam ArgTs Arguments of the completion Callback
+ */
+template <typename Initiator, typename... ArgTs>
+class CallbackInitiatedAwaiter : public CallbackAwaiter<ArgTs...> {
+   public:
+    explicit CallbackInitiatedAwaiter(Initiator initiator) : _initiator(std::move(initiator)) {}
+
+    inline bool await_ready() const noexcept { return false; }
+
+    inline bool await_suspend(const std::coroutine_handle<> handle) {
+        // The handle is set before the operation starts, but the coroutine only counts as suspended
+        // afterwards. So a Callback fired right away never resumes it from inside of here.
+        this->_handle = handle;
+        _initiator(this->callback());
+        return this->_suspend();
+    }
+
+   private:
+    Initiator _initiator;
+};
+
+/**
+ * @brief Await a Callback based operation
+ *
+ * Usage: int result = co_await awaitCallback<int>([&](Callback<void, int> done) {
+ *            driver.read(buffer, done);
+ *        });
+ *
+ * @tparam ArgTs Arguments of the completion Callback
+ * @tparam Initiator
+ * @param initiator Called with the completion Callback once the coroutine awaits
+ * @return CallbackInitiatedAwaiter<Initiator, ArgTs...>
+ */
+template <typename... ArgTs, typename Initiator>
+CallbackInitiatedAwaiter<typename std::decay<Initiator>::type, ArgTs...> awaitCallback(
+    Initiator &&initiator) {
+    return CallbackInitiatedAwaiter<typename std::decay<Initiator>::type, ArgTs...>(
+        std::forward<Initiator>(initiator));
+}
+
+#endif
+#endif
@@ -0,0 +1,334 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Thread pool running Callbacks, with work stealing and a parallelFor
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "callback.hpp"
+#include "callback_queue.hpp"
+
+/**
+ * @brief Runs Callbacks on a fixed amount of worker threads
+ *
+ * Every worker has its own MpmcCallbackQueue, tasks are stored by value in its slots (Callback and
+ * Arguments), so submitting never allocates. Tasks submitted from a worker go to its own queue,
+ * others are spread round-robin. A worker without work steals from the queues of the others and
+ * sleeps only if there is nothing to steal.
+ *
+ * NOTE: Unlike a work-stealing deque (Chase-Lev), the queues are FIFO for their worker and for
+ * thieves alike: a worker runs its oldest task first, not the one it submitted last. So a task
+ * submitted from a task does not run while its data is still in the cache of the worker, and
+ * deep recursive splitting queues up breadth first. In return any thread may push to any queue,
+ * which external submits and the fallback to other full queues need, and the tasks stay in the
+ * slots by value, including move-only ones.
+ *
+ * @tparam Workers Amount of worker threads
+ * @tparam QueueCapacity Capacity of the queue of each worker, has to be a power of two
+ * @tparam CallbackT The type of the tasks, its Arguments are stored with it. May be a
+ * UniqueCallback for tasks owning their resources. submitBatch() and parallelFor() need a
+ * CallbackT without Arguments.
+ */
+template <std::size_t Workers, std::size_t QueueCapacity = 256,
+          typename CallbackT = Callback<void>>
+class CallbackExecutor {
+    static_assert(Workers > 0, "At least one worker is needed!");
+
+   public:
+    /**
+     * @brief Starts the workers
+     *
+     */
+    CallbackExecutor() : _next(0), _submitted(0), _pending(0), _sleepers(0), _stopping(false) {
+        for (std::size_t i = 0; i < Workers; i++) {
+            _threads[i] = std::thread(&CallbackExecutor::_work, this, i);
+        }
+    }
+
+    CallbackExecutor(const CallbackExecutor &) = delete;
+    CallbackExecutor &operator=(const CallbackExecutor &) = delete;
+
+    /**
+     * @brief Runs all remaining tasks and stops the workers
+     *
+     */
+    ~CallbackExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping.store(true);
+        }
+
+        _wake.notify_all();
+
+        for (std::size_t i = 0; i < Workers; i++) {
+            _threads[i].join();
+        }
+    }
+
+    /**
+     * @brief Run a Callback on one of the workers
+     *
+     * @param callback The CallbackT (or what it is constructed from), only moved from if it was
+     * queued
+     * @param values The Arguments the Callback will be called with
+     * @return true The task was queued
+     * @return false All queues are full
+     */
+    template <typename C, typename... ValueTs>
+    bool submit(C &&callback, ValueTs &&...values) {
+        if (!_push(std::forward<C>(callback), std::forward<ValueTs>(values)...)) {
+            return false;
+        }
+
+        _notify(1);
+        return true;
+    }
+
+    /**
+     * @brief Run count Callbacks, the workers are only woken up once. CallbackT has to be
+     * copyable and take no Arguments.
+     *
+     * @param callbacks
+     * @param count
+     * @return std::size_t Amount of queued tasks, less than count if the queues are full
+     */
+    std::size_t submitBatch(const CallbackT *const callbacks, const std::size_t count) {
+        static_assert(_takesNoArguments<CallbackT>(0),
+                      "submitBatch() has no Arguments to call the Callbacks with!");
+
+        std::size_t queued = 0;
+
+        for (; queued < count; queued++) {
+            if (!_push(callbacks[queued])) {
+                break;
+            }
+        }
+
+        _notify(queued);
+        return queued;
+    }
+
+    /**
+     * @brief Call body for every index in [begin, end), spread over the workers and the calling
+     * thread, and return once all calls are done. The indices are handed out in chunks of grain.
+     *
+     * Nothing is allocated, the shared state lives on the stack of the caller. While waiting the
+     * caller runs other tasks, so it may be called from a task as well. The helpers are submitted
+     * as tasks, so CallbackT has to take no Arguments and has to be constructible from a Functor
+     * capturing a reference.
+     *
+     * @param begin
+     * @param end
+     * @param body
+     * @param grain Amount of indices handed out at once
+     */
+    void parallelFor(const std::size_t begin, const std::size_t end,
+                     const Callback<void, std::size_t> &body, const std::size_t grain = 1) {
+        static_assert(_takesNoArguments<CallbackT>(0),
+                      "parallelFor() submits its helpers as tasks without Arguments!");
+
+        if (begin >= end) {
+            return;
+        }
+
+        ParallelFor shared(begin, end, body, grain < 1 ? 1 : grain);
+        const std::size_t chunks = (end - begin + shared.grain - 1) / shared.grain;
+        const std::size_t helpers = chunks - 1 < Workers ? chunks - 1 : Workers;
+
+        for (std::size_t i = 0; i < helpers; i++) {
+            shared.helpers.fetch_add(1);
+
+            if (!submit([&shared]() { shared.help(); })) {
+                shared.helpers.fetch_sub(1);
+                break;
+            }
+        }
+
+        shared.work();
+
+        while (shared.helpers.load(std::memory_order_acquire) != 0) {
+            if (!_runOne(_current())) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief Wait until all submitted tasks are done, the caller helps running them
+     *
+     */
+    void wait() {
+        while (_pending.load(std::memory_order_acquire) != 0) {
+            if (!_runOne(_current())) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    static constexpr std::size_t workers() { return Workers; }
+
+   private:
+    using Queue = MpmcCallbackQueue<QueueCapacity, CallbackT>;
+
+    /**
+     * @brief State of a parallelFor(), shared by the caller and the helper tasks
+     *
+     */
+    struct ParallelFor {
+        ParallelFor(const std::size_t begin, const std::size_t end,
+                    const Callback<void, std::size_t> &body, const std::size_t grain)
+            : body(body), end(end), grain(grain), next(begin), helpers(0) {}
+
+        const Callback<void, std::size_t> &body;
+        const std::size_t end;
+        const std::size_t grain;
+        std::atomic<std::size_t> next;
+        std::atomic<std::size_t> helpers;
+
+        void work() {
+            for (std::size_t first = next.fetch_add(grain); first < end;
+                 first = next.fetch_add(grain)) {
+                const std::size_t last = end - first < grain ? end : first + grain;
+
+                for (std::size_t i = first; i < last; i++) {
+                    body(i);
+                }
+            }
+        }
+
+        void help() {
+            work();
+            helpers.fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+    Queue _queues[Workers];
+    std::thread _threads[Workers];
+    std::atomic<std::size_t> _next;        // Queue of the next external submit
+    std::atomic<std::size_t> _submitted;   // Increased on every submit, to not miss a wake up
+    std::atomic<std::size_t> _pending;     // Submitted and not yet done
+    std::atomic<std::size_t> _sleepers;
+    std::atomic<bool> _stopping;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+
+    /**
+     * @brief Index of the worker the calling thread is, Workers if it is none of this executor
+     *
+     */
+    static thread_local const CallbackExecutor *_worker;
+    static thread_local std::size_t _workerIndex;
+
+    inline std::size_t _current() const { return _worker == this ? _workerIndex : Workers; }
+
+    template <typename C, typename = decltype(std::declval<C &>()())>
+    static constexpr bool _takesNoArguments(int) {
+        return true;
+    }
+
+    template <typename C>
+    static constexpr bool _takesNoArguments(...) {
+        return false;
+    }
+
+    /**
+     * @brief Queue a task, the queue of the calling worker (or the next one) first and the others
+     * if it is full
+     *
+     */
+    template <typename C, typename... ValueTs>
+    bool _push(C &&callback, ValueTs &&...values) {
+        const std::size_t current = _current();
+        const std::size_t first =
+            current < Workers ? current : _next.fetch_add(1, std::memory_order_relaxed) % Workers;
+
+        _pending.fetch_add(1);
+
+        for (std::size_t i = 0; i < Workers; i++) {
+            if (_queues[(first + i) % Workers].push(std::forward<C>(callback),
+                                                    std::forward<ValueTs>(values)...)) {
+                return true;
+            }
+        }
+
+        _pending.fetch_sub(1);
+        return false;
+    }
+
+    void _notify(const std::size_t count) {
+        if (count == 0) {
+            return;
+        }
+
+        _submitted.fetch_add(1);
+
+        if (_sleepers.load() != 0) {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (count == 1) {
+                _wake.notify_one();
+            } else {
+                _wake.notify_all();
+            }
+        }
+    }
+
+    /**
+     * @brief Run one task, from the own queue first and else stolen from the others
+     *
+     * @param index Worker to start with
+     * @return true A task was run
+     * @return false All queues are empty
+     */
+    bool _runOne(const std::size_t index) {
+        const std::size_t first = index < Workers ? index : 0;
+
+        for (std::size_t i = 0; i < Workers; i++) {
+            if (_queues[(first + i) % Workers].drain(1) != 0) {
+                _pending.fetch_sub(1, std::memory_order_release);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void _work(const std::size_t index) {
+        _worker = this;
+        _workerIndex = index;
+
+        while (true) {
+            const std::size_t submitted = _submitted.load();
+
+            if (_runOne(index)) {
+                continue;
+            }
+
+            if (_stopping.load()) {
+                break;
+            }
+
+            // Sleep until something is submitted after the queues were found empty
+            std::unique_lock<std::mutex> lock(_mutex);
+            _sleepers.fetch_add(1);
+            _wake.wait(lock, [&] { return _submitted.load() != submitted || _stopping.load(); });
+            _sleepers.fetch_sub(1);
+        }
+    }
+};
+
+template <std::size_t Workers, std::size_t QueueCapacity, typename CallbackT>
+thread_local const CallbackExecutor<Workers, QueueCapacity, CallbackT>
+    *CallbackExecutor<Workers, QueueCapacity, CallbackT>::_worker = nullptr;
+
+template <std::size_t Workers, std::size_t QueueCapacity, typename CallbackT>
+thread_local std::size_t CallbackExecutor<Workers, QueueCapacity, CallbackT>::_workerIndex = 0;
@@ -0,0 +1,321 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Call count and latency histograms of Callbacks, enabled with CONFIG_CALLBACK_INSTRUMENT
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+
+// CALLBACK_INSTRUMENT_TIMESTAMP(): Expression returning the current time as uint32_t (e.g.
+// DWT->CYCCNT on Cortex-M or the TSC), only the difference of two timestamps is used. Defaults to
+// std::chrono::steady_clock in nanoseconds on PC builds.
+#ifndef CALLBACK_INSTRUMENT_TIMESTAMP
+#ifdef PC_BUILD
+#include <chrono>
+#define CALLBACK_INSTRUMENT_TIMESTAMP()                                              \
+    ((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(                 \
+         std::chrono::steady_clock::now().time_since_epoch())                        \
+         .count())
+#else
+#error "CONFIG_CALLBACK_INSTRUMENT needs CALLBACK_INSTRUMENT_TIMESTAMP() to be defined!"
+#endif
+#endif
+
+// Maximum amount of threads (or contexts with their own thread_local storage) recording calls. A
+// thread takes its table on its first call and keeps it.
+#ifndef CONFIG_CALLBACK_INSTRUMENT_THREADS
+#ifdef PC_BUILD
+#define CONFIG_CALLBACK_INSTRUMENT_THREADS 16
+#else
+#define CONFIG_CALLBACK_INSTRUMENT_THREADS 2
+#endif
+#endif
+
+// Maximum amount of different targets recorded per thread
+#ifndef CONFIG_CALLBACK_INSTRUMENT_ENTRIES
+#ifdef PC_BUILD
+#define CONFIG_CALLBACK_INSTRUMENT_ENTRIES 256
+#else
+#define CONFIG_CALLBACK_INSTRUMENT_ENTRIES 16
+#endif
+#endif
+
+class CallbackUnknownClass;
+
+/**
+ * @brief Recorded calls of one target on one thread. A target is identified by the invoker of
+ * the Callback and the data its caller binds at runtime: the Function for Callbacks to Functions,
+ * the Object for Callbacks to Methods bound at compile time and the Object followed by the Method
+ * for Callbacks to Methods bound at runtime. The invoker alone tells compile time bound Functions
+ * and Functors, their data is zero, so a Functor is recorded once no matter what it captured.
+ *
+ * Histogram bucket i counts the calls which took [2^(i-1), 2^i) ticks, bucket 0 the ones below 1.
+ *
+ */
+struct CallbackInstrumentStats {
+    // Words of data, enough for an Object and a Method pointer of any class
+    static constexpr std::size_t dataWords =
+        (sizeof(void *) + sizeof(void (CallbackUnknownClass::*)()) + sizeof(uintptr_t) - 1) /
+        sizeof(uintptr_t);
+
+    uintptr_t invoker;
+    uintptr_t data[dataWords];
+    std::size_t thread;
+    uint32_t count;
+    uint32_t maxTicks;
+    uint64_t totalTicks;
+    uint32_t histogram[32];
+};
+
+/**
+ * @brief Per thread tables of the recorded calls, forEach() may read all tables from anywhere at
+ * any time.
+ *
+ * A table is taken by a thread, but an ISR (which has no thread_local storage of its own) records
+ * into the table of the thread it interrupted. So the stats are updated with atomic
+ * read-modify-writes and a new Entry is claimed with a CAS before its data is written, an Entry
+ * claimed by an interrupted context is skipped instead of waited for. If both contexts record a
+ * new target at the same time, it may get two Entries, both are reported by forEach().
+ *
+ * NOTE: Without lock-free 64 bit atomics (e.g. Cortex-M), std::atomic<uint64_t> of totalTicks
+ * may take a lock in the runtime library, which is not safe from an ISR.
+ *
+ * @tparam Threads Amount of tables
+ * @tparam Entries Amount of targets per table, a power of two
+ */
+template <std::size_t Threads = CONFIG_CALLBACK_INSTRUMENT_THREADS,
+          std::size_t Entries = CONFIG_CALLBACK_INSTRUMENT_ENTRIES>
+class CallbackInstrument {
+    static_assert(Threads > 0, "At least one table is needed!");
+    static_assert(Entries > 0 && (Entries & (Entries - 1)) == 0,
+                  "Entries have to be a power of two!");
+
+   public:
+    /**
+     * @brief Record a call into the table of the calling thread
+     *
+     * @param invoker
+     * @param data Has CallbackInstrumentStats::dataWords words
+     * @param ticks Duration of the call
+     */
+    static void record(const uintptr_t invoker, const uintptr_t *const data,
+                       const uint32_t ticks) {
+        if (invoker == 0) {
+            return;
+        }
+
+        Entry *const entry = _entry(invoker, data);
+
+        if (entry == nullptr) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        entry->count.fetch_add(1, std::memory_order_relaxed);
+        entry->totalTicks.fetch_add(ticks, std::memory_order_relaxed);
+        entry->histogram[_bucket(ticks)].fetch_add(1, std::memory_order_relaxed);
+
+        uint32_t maxTicks = entry->maxTicks.load(std::memory_order_relaxed);
+
+        while (ticks > maxTicks &&
+               !entry->maxTicks.compare_exchange_weak(maxTicks, ticks, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Call visitor with the stats of every recorded target of every thread. The stats are
+     * a snapshot and may lag behind calls running meanwhile.
+     *
+     * Usage: CallbackInstrument<>::forEach([](const CallbackInstrumentStats &stats) { ... });
+     *
+     * @tparam Visitor Called with const CallbackInstrumentStats &
+     * @param visitor
+     */
+    template <typename Visitor>
+    static void forEach(Visitor &&visitor) {
+        const std::size_t used = _used.load(std::memory_order_acquire);
+        CallbackInstrumentStats stats;
+
+        for (std::size_t thread = 0; thread < used && thread < Threads; thread++) {
+            for (std::size_t i = 0; i < Entries; i++) {
+                const Entry &entry = _tables[thread].entries[i];
+                stats.invoker = entry.invoker.load(std::memory_order_acquire);
+
+                if (stats.invoker == 0 || stats.invoker == _claimed) {
+                    continue;
+                }
+
+                memcpy(stats.data, entry.data, sizeof(stats.data));
+                stats.thread = thread;
+                stats.count = entry.count.load(std::memory_order_relaxed);
+                stats.maxTicks = entry.maxTicks.load(std::memory_order_relaxed);
+                stats.totalTicks = entry.totalTicks.load(std::memory_order_relaxed);
+
+                for (std::size_t bucket = 0; bucket < 32; bucket++) {
+                    stats.histogram[bucket] =
+                        entry.histogram[bucket].load(std::memory_order_relaxed);
+                }
+
+                visitor((const CallbackInstrumentStats &)stats);
+            }
+        }
+    }
+
+    /**
+     * @brief Get the amount of calls which were not recorded, as all tables or all entries of the
+     * table of their thread were in use
+     *
+     * @return uint32_t
+     */
+    static inline uint32_t dropped() { return _dropped.load(std::memory_order_relaxed); }
+
+   private:
+    // Invoker of an Entry whose data is being written, never the address of a function
+    static constexpr uintptr_t _claimed = 1;
+
+    struct Entry {
+        std::atomic<uintptr_t> invoker;   // Set last, 0 while unused, _claimed while written
+        uintptr_t data[CallbackInstrumentStats::dataWords];
+        std::atomic<uint32_t> count;
+        std::atomic<uint32_t> maxTicks;
+        std::atomic<uint64_t> totalTicks;
+        std::atomic<uint32_t> histogram[32];
+    };
+
+    struct Table {
+        Entry entries[Entries];
+    };
+
+    static Table _tables[Threads];
+    static std::atomic<std::size_t> _used;
+    static std::atomic<uint32_t> _dropped;
+
+    static inline std::size_t _bucket(uint32_t ticks) {
+        std::size_t bucket = 0;
+
+        while (ticks != 0 && bucket < 31) {
+            ticks >>= 1;
+            bucket++;
+        }
+
+        return bucket;
+    }
+
+    /**
+     * @brief Get the table of the calling thread, a free one is taken on its first call
+     *
+     * @return Table* nullptr if all tables are in use
+     */
+    static Table *_table() {
+        static thread_local Table *table = nullptr;
+        static thread_local bool assigned = false;
+
+        if (!assigned) {
+            assigned = true;
+            const std::size_t index = _used.fetch_add(1, std::memory_order_acq_rel);
+
+            if (index < Threads) {
+                table = &_tables[index];
+            }
+        }
+
+        return table;
+    }
+
+    /**
+     * @brief Find the Entry of a target in the table of the calling thread by open addressing,
+     * a free one is claimed for a new target
+     *
+     * @return Entry* nullptr if the table is full
+     */
+    static Entry *_entry(const uintptr_t invoker, const uintptr_t *const data) {
+        Table *const table = _table();
+
+        if (table == nullptr) {
+            return nullptr;
+        }
+
+        uintptr_t hash = invoker;
+
+        for (std::size_t i = 0; i < CallbackInstrumentStats::dataWords; i++) {
+            hash = (hash ^ data[i]) * 0x9E3779B9u;
+            hash ^= hash >> 16;
+        }
+
+        for (std::size_t probe = 0; probe < Entries; probe++) {
+            Entry &entry = table->entries[(hash + probe) & (Entries - 1)];
+            uintptr_t current = entry.invoker.load(std::memory_order_acquire);
+
+            // Claim a free one, fails if another context (e.g. an ISR) took it meanwhile
+            if (current == 0 &&
+                entry.invoker.compare_exchange_strong(current, _claimed,
+                                                      std::memory_order_acquire)) {
+                memcpy(entry.data, data, sizeof(entry.data));
+                entry.invoker.store(invoker, std::memory_order_release);
+                return &entry;
+            }
+
+            if (current == invoker && memcmp(entry.data, data, sizeof(entry.data)) == 0) {
+                return &entry;
+            }
+        }
+
+        return nullptr;
+    }
+};
+
+template <std::size_t Threads, std::size_t Entries>
+typename CallbackInstrument<Threads, Entries>::Table
+    CallbackInstrument<Threads, Entries>::_tables[Threads];
+
+template <std::size_t Threads, std::size_t Entries>
+std::atomic<std::size_t> CallbackInstrument<Threads, Entries>::_used(0);
+
+template <std::size_t Threads, std::size_t Entries>
+std::atomic<uint32_t> CallbackInstrument<Threads, Entries>::_dropped(0);
+
+/**
+ * @brief Records the duration of a call from its construction to its destruction, used by the
+ * callers of InplaceCallback. Callers which only forward to another Callback (bindFront(), on())
+ * record nothing, the Callback they forward to records the call.
+ *
+ */
+class CallbackInstrumentScope {
+   public:
+    /**
+     * @brief Start recording a call
+     *
+     * @tparam Invoker
+     * @param invoker The invoker of the Callback
+     * @param data Data the caller binds at runtime, nullptr if the invoker tells the target
+     * @param size Bytes of data, at most CallbackInstrumentStats::dataWords words
+     */
+    template <typename Invoker>
+    inline CallbackInstrumentScope(const Invoker invoker, const void *const data = nullptr,
+                                   const std::size_t size = 0) noexcept
+        : _invoker(0), _data(), _start(CALLBACK_INSTRUMENT_TIMESTAMP()) {
+        memcpy(&_invoker, &invoker,
+               sizeof(invoker) < sizeof(_invoker) ? sizeof(invoker) : sizeof(_invoker));
+
+        if (data != nullptr) {
+            memcpy(_data, data, size < sizeof(_data) ? size : sizeof(_data));
+        }
+    }
+
+    inline ~CallbackInstrumentScope() {
+        CallbackInstrument<>::record(_invoker, _data,
+                                     (uint32_t)(CALLBACK_INSTRUMENT_TIMESTAMP() - _start));
+    }
+
+   private:
+    uintptr_t _invoker;
+    uintptr_t _data[CallbackInstrumentStats::dataWords];
+    const uint32_t _start;
+};
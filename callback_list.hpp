@@ -0,0 +1,463 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Fixed capacity list of Callbacks, called all at once (multicast / signal)
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+#include "callback.hpp"
+
+/**
+ * @brief Combiner for CallbackList::emit(): true once a Callback returns true, the following ones
+ * are not called anymore (e.g. event filter chains, where the first consumer wins)
+ *
+ */
+struct CallbackFirstTrue {
+    template <typename R>
+    class Combine {
+       public:
+        using Result = bool;
+
+        inline bool add(const R &value) {
+            _result = (bool)value;
+            return !_result;
+        }
+
+        inline Result result() const { return _result; }
+
+       private:
+        bool _result = false;
+    };
+};
+
+/**
+ * @brief Combiner for CallbackList::emit(): Sum of all results, R() if the list is empty
+ *
+ */
+struct CallbackSum {
+    template <typename R>
+    class Combine {
+       public:
+        using Result = R;
+
+        inline bool add(R value) {
+            _result += std::move(value);
+            return true;
+        }
+
+        inline Result result() { return std::move(_result); }
+
+       private:
+        R _result = R();
+    };
+};
+
+/**
+ * @brief Combiner for CallbackList::emit(): Result of the last Callback, R() if the list is empty
+ *
+ */
+struct CallbackLast {
+    template <typename R>
+    class Combine {
+       public:
+        using Result = R;
+
+        inline bool add(R value) {
+            _result = std::move(value);
+            return true;
+        }
+
+        inline Result result() { return std::move(_result); }
+
+       private:
+        R _result = R();
+    };
+};
+
+/**
+ * @brief Results collected by CallbackCollect
+ *
+ * @tparam R
+ * @tparam Size
+ */
+template <typename R, std::size_t Size>
+struct CallbackResults {
+    std::size_t count = 0;
+    R values[Size];
+};
+
+/**
+ * @brief Combiner for CallbackList::emit(): Collects the results in order into a fixed array,
+ * stops once it is full
+ *
+ * @tparam Size Maximum amount of results
+ */
+template <std::size_t Size>
+struct CallbackCollect {
+    static_assert(Size > 0, "Nothing to collect into!");
+
+    template <typename R>
+    class Combine {
+       public:
+        using Result = CallbackResults<R, Size>;
+
+        inline bool add(R value) {
+            _result.values[_result.count++] = std::move(value);
+            return _result.count < Size;
+        }
+
+        inline Result result() { return std::move(_result); }
+
+       private:
+        Result _result;
+    };
+};
+
+/**
+ * @brief A list of Callbacks which are all called on emit()
+ *
+ * The Callbacks are stored inline in two snapshots (no dynamic memory). emit() always runs on the
+ * currently published snapshot and never blocks, even while another thread adds or removes a
+ * Callback. Writers copy the published snapshot into the other one, modify it and publish it.
+ *
+ * NOTE: Writers are serialized and wait for emits still running on the snapshot they are going to
+ * overwrite. So never add() or remove() from a context which can preempt an emit() (e.g. an ISR),
+ * emit() itself is safe from anywhere. A Callback may change the list it is called by, but only
+ * once per emit(): the next change would have to overwrite the snapshot its own emit() still
+ * reads, so add(), remove() and clear() return false instead (detected per thread). A change from
+ * inside an emit() never waits for another writer (which may wait for that emit() to finish), it
+ * returns false as well if another thread is changing the list at the same time.
+ *
+ * @tparam Capacity Maximum amount of Callbacks
+ * @tparam R Return type of the Callbacks
+ * @tparam ArgTs Optional Arguments
+ */
+template <std::size_t Capacity, typename R, typename... ArgTs>
+class CallbackList {
+   public:
+    /**
+     * @brief Creates an empty list
+     *
+     */
+    CallbackList() : _active(0), _readers{{0}, {0}} {}
+
+    CallbackList(const CallbackList &) = delete;
+    CallbackList &operator=(const CallbackList &) = delete;
+
+    /**
+     * @brief Add a Callback to the list
+     *
+     * @param callback
+     * @return true Callback was added
+     * @return false The list is full, the Callback is not set or (called during an emit() of the
+     * list) the list was already changed during it or another thread is changing it
+     */
+    bool add(const Callback<R, ArgTs...> &callback) {
+        uint8_t active;
+
+        if (!callback.isCallbackSet() || !_lock(active)) {
+            return false;
+        }
+
+        const Snapshot &source = _snapshots[active];
+
+        if (source.count >= Capacity) {
+            _unlock();
+            return false;
+        }
+
+        Snapshot &target = _snapshots[active ^ 1];
+
+        for (std::size_t i = 0; i < source.count; i++) {
+            target.callbacks[i] = source.callbacks[i];
+        }
+
+        target.callbacks[source.count] = callback;
+        target.count = source.count + 1;
+
+        _publish(active ^ 1);
+        return true;
+    }
+
+#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
+    /**
+     * @brief Remove the first Callback pointing to the same destination (see pointToSame())
+     *
+     * @param callback
+     * @return true A Callback was removed
+     * @return false No Callback pointing to the same destination in the list or (called during
+     * an emit() of the list) the list was already changed during it or another thread is changing
+     * it
+     */
+    bool remove(const Callback<R, ArgTs...> &callback) {
+        uint8_t active;
+
+        if (!_lock(active)) {
+            return false;
+        }
+
+        const Snapshot &source = _snapshots[active];
+        Snapshot &target = _snapshots[active ^ 1];
+
+        std::size_t count = 0;
+        bool removed = false;
+
+        for (std::size_t i = 0; i < source.count; i++) {
+            if (!removed && source.callbacks[i].pointToSame(callback)) {
+                removed = true;
+                continue;
+            }
+
+            target.callbacks[count++] = source.callbacks[i];
+        }
+
+        if (!removed) {
+            _unlock();
+            return false;
+        }
+
+        target.count = count;
+
+        _publish(active ^ 1);
+        return true;
+    }
+#endif
+
+    /**
+     * @brief Remove all Callbacks
+     *
+     * @return true
+     * @return false Called during an emit() of the list, which already changed it, or another
+     * thread is changing it
+     */
+    bool clear() {
+        uint8_t active;
+
+        if (!_lock(active)) {
+            return false;
+        }
+
+        _snapshots[active ^ 1].count = 0;
+        _publish(active ^ 1);
+        return true;
+    }
+
+    /**
+     * @brief Call all Callbacks in the order they were added. The Arguments are taken as
+     * CallbackForwardType, so a by-value Argument is only constructed by the parameters of the
+     * destinations. Only the last Callback gets them forwarded, the others as lvalues.
+     *
+     * @param args
+     */
+    void emit(CallbackForwardType<ArgTs>... args) const {
+        const Reader reader(*this);
+        const Snapshot &snapshot = _snapshots[reader.index];
+
+        if (snapshot.count == 0) {
+            return;
+        }
+
+        const std::size_t last = snapshot.count - 1;
+
+        for (std::size_t i = 0; i < last; i++) {
+            snapshot.callbacks[i](args...);
+        }
+
+        snapshot.callbacks[last](callbackForward<ArgTs>(args)...);
+    }
+
+    /**
+     * @brief Call the Callbacks in the order they were added and combine their results, see
+     * CallbackFirstTrue, CallbackSum, CallbackLast and CallbackCollect. Stops as soon as the
+     * Combiner has its result, the remaining Callbacks are not called.
+     *
+     * Usage: bool consumed = list.emit<CallbackFirstTrue>(event);
+     *
+     * @tparam Combiner Policy with a template class Combine<R>, whose add() takes each result and
+     * returns false once the combined Result is known
+     * @param args
+     * @return Combiner::Combine<R>::Result
+     */
+    template <typename Combiner>
+    typename Combiner::template Combine<R>::Result emit(
+        CallbackForwardType<ArgTs>... args) const {
+        static_assert(!std::is_void<R>::value, "Results of void Callbacks can not be combined!");
+
+        typename Combiner::template Combine<R> combine;
+        {
+            const Reader reader(*this);
+            const Snapshot &snapshot = _snapshots[reader.index];
+
+            if (snapshot.count != 0) {
+                const std::size_t last = snapshot.count - 1;
+                std::size_t i = 0;
+
+                while (i < last && combine.add(snapshot.callbacks[i](args...))) {
+                    i++;
+                }
+
+                if (i == last) {
+                    combine.add(snapshot.callbacks[last](callbackForward<ArgTs>(args)...));
+                }
+            }
+        }
+
+        return combine.result();
+    }
+
+    /**
+     * @brief Shorthand for emit()
+     *
+     * @param args
+     */
+    inline void operator()(CallbackForwardType<ArgTs>... args) const {
+        emit(callbackForward<ArgTs>(args)...);
+    }
+
+    /**
+     * @brief Get the amount of Callbacks in the list
+     *
+     * @return std::size_t
+     */
+    std::size_t size() const {
+        const Reader reader(*this);
+        return _snapshots[reader.index].count;
+    }
+
+    /**
+     * @brief Get the maximum amount of Callbacks
+     *
+     * @return constexpr std::size_t
+     */
+    static constexpr std::size_t capacity() { return Capacity; }
+
+   private:
+    struct Snapshot {
+        std::size_t count = 0;
+        Callback<R, ArgTs...> callbacks[Capacity];
+    };
+
+    /**
+     * @brief Registers as reader of a snapshot while it exists. The readers of a thread are
+     * chained, so a writer can tell if its own thread reads a snapshot.
+     *
+     */
+    class Reader {
+       public:
+        Reader(const CallbackList &list)
+            : list(list), index(list._acquire()), _previous(CallbackList::_reader) {
+            CallbackList::_reader = this;
+        }
+
+        Reader(const Reader &) = delete;
+        Reader &operator=(const Reader &) = delete;
+
+        ~Reader() {
+            CallbackList::_reader = _previous;
+            list._release(index);
+        }
+
+        const CallbackList &list;
+        const uint8_t index;
+
+       private:
+        friend class CallbackList;
+
+        const Reader *const _previous;
+    };
+
+    Snapshot _snapshots[2];
+    std::atomic<uint8_t> _active;
+    mutable std::atomic<uint32_t> _readers[2];
+    std::atomic_flag _writing = ATOMIC_FLAG_INIT;
+
+    static thread_local const Reader *_reader;   // Innermost Reader of the thread
+
+    /**
+     * @brief Register as reader of the published snapshot. If a writer published another snapshot
+     * in between, the registration is retried on the new one, so a writer never overwrites a
+     * snapshot which is read.
+     *
+     * @return uint8_t Index of the snapshot to read
+     */
+    uint8_t _acquire() const {
+        uint8_t index = _active.load();
+
+        while (true) {
+            _readers[index].fetch_add(1);
+
+            const uint8_t current = _active.load();
+            if (current == index) {
+                return index;
+            }
+
+            _readers[index].fetch_sub(1);
+            index = current;
+        }
+    }
+
+    inline void _release(const uint8_t index) const {
+        _readers[index].fetch_sub(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Become the only writer and wait until the unpublished snapshot is not read anymore.
+     * If this thread reads a snapshot of the list itself, it does not wait for another writer, as
+     * that one may wait for this thread to finish reading.
+     *
+     * @param active Set to the index of the published snapshot
+     * @return true
+     * @return false This thread reads the unpublished snapshot, or reads a snapshot while another
+     * thread writes
+     */
+    bool _lock(uint8_t &active) {
+        bool reading = false;
+
+        for (const Reader *reader = _reader; reader != nullptr; reader = reader->_previous) {
+            if (&reader->list == this) {
+                reading = true;
+                break;
+            }
+        }
+
+        while (_writing.test_and_set(std::memory_order_acquire)) {
+            if (reading) {
+                return false;
+            }
+        }
+
+        active = _active.load(std::memory_order_relaxed);
+
+        for (const Reader *reader = _reader; reader != nullptr; reader = reader->_previous) {
+            if (&reader->list == this && reader->index != active) {
+                _unlock();
+                return false;
+            }
+        }
+
+        while (_readers[active ^ 1].load() != 0) {
+        }
+
+        return true;
+    }
+
+    inline void _unlock() { _writing.clear(std::memory_order_release); }
+
+    inline void _publish(const uint8_t index) {
+        _active.store(index);
+        _unlock();
+    }
+};
+
+template <std::size_t Capacity, typename R, typename... ArgTs>
+thread_local const typename CallbackList<Capacity, R, ArgTs...>::Reader
+    *CallbackList<Capacity, R, ArgTs...>::_reader = nullptr;
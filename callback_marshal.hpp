@@ -0,0 +1,402 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Marshal calls of a Callback to the mailbox of the thread or core owning its destination
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "callback.hpp"
+#include "callback_queue.hpp"
+#include "callback_unique.hpp"
+
+// CALLBACK_FUTURE_WAIT(): Statement run while CallbackFuture::wait() polls, e.g. __WFE() on
+// Cortex-M. Defaults to std::this_thread::yield() on PC builds.
+#ifndef CALLBACK_FUTURE_WAIT
+#ifdef PC_BUILD
+#include <thread>
+#define CALLBACK_FUTURE_WAIT() std::this_thread::yield()
+#else
+#define CALLBACK_FUTURE_WAIT()
+#endif
+#endif
+
+// CALLBACK_MARSHAL_DROPPED(): Statement run when a call of a Callback returned by
+// InplaceCallback::on() or bindOn() is dropped as the mailbox is full, e.g. to count drops or to
+// assert. Does nothing by default.
+#ifndef CALLBACK_MARSHAL_DROPPED
+#define CALLBACK_MARSHAL_DROPPED()
+#endif
+
+// Buffer size of the entries of a CallbackMailbox, has to hold a Callback, a CallbackFuture
+// pointer and copies of the Arguments
+#ifndef CONFIG_CALLBACK_MAILBOX_ENTRY_SIZE
+#ifdef PC_BUILD
+#define CONFIG_CALLBACK_MAILBOX_ENTRY_SIZE 64   // Byte
+#else
+#define CONFIG_CALLBACK_MAILBOX_ENTRY_SIZE 32   // Byte
+#endif
+#endif
+
+/**
+ * @brief Mailbox of a thread or core, any context may push, the owner drain()s it in its loop
+ *
+ * Holds Callbacks of any signature together with copies of their Arguments, see
+ * InplaceCallback::on().
+ *
+ * @tparam Capacity Maximum amount of queued calls, has to be a power of two
+ * @tparam EntrySize Buffer size of each queued call
+ */
+template <std::size_t Capacity, std::size_t EntrySize = CONFIG_CALLBACK_MAILBOX_ENTRY_SIZE>
+using CallbackMailbox = MpscCallbackQueue<Capacity, InplaceUniqueCallback<EntrySize, void>>;
+
+template <typename CallbackT, typename Return, typename... ArgTs>
+class CallbackMarshalCall;
+
+template <typename Mailbox, typename CallbackT>
+class MarshalledCallback;
+
+/**
+ * @brief State of a CallbackFuture, shared by all result types
+ *
+ */
+class CallbackFutureState {
+   public:
+    CallbackFutureState() : _state(idle) {}
+
+    CallbackFutureState(const CallbackFutureState &) = delete;
+    CallbackFutureState &operator=(const CallbackFutureState &) = delete;
+
+    /**
+     * @brief Check if the call ran and its result is available
+     *
+     * @return true
+     * @return false
+     */
+    inline bool ready() const { return _state.load(std::memory_order_acquire) == done; }
+
+    /**
+     * @brief Check if the call was not posted, as the mailbox was full. It never completes.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool dropped() const { return _state.load(std::memory_order_relaxed) == full; }
+
+    /**
+     * @brief Wait until the posted call ran, polling with CALLBACK_FUTURE_WAIT(). Returns at
+     * once if no call is pending, e.g. if it was dropped.
+     *
+     */
+    void wait() const {
+        while (_state.load(std::memory_order_acquire) == pending) {
+            CALLBACK_FUTURE_WAIT();
+        }
+    }
+
+   protected:
+    template <typename, typename>
+    friend class MarshalledCallback;
+
+    // Not posted (or reset), posted and not yet run, ran, not posted as the mailbox was full
+    enum State : uint8_t { idle, pending, done, full };
+
+    std::atomic<uint8_t> _state;
+
+    // Set before the push, the owner of the mailbox may complete the call right away
+    inline void _post() { _state.store(pending, std::memory_order_relaxed); }
+
+    inline void _drop() { _state.store(full, std::memory_order_relaxed); }
+
+    inline void _complete() { _state.store(done, std::memory_order_release); }
+};
+
+/**
+ * @brief Completion of a marshalled call, set by the owner of the mailbox after the call ran
+ *
+ * Owned by the caller and has to outlive the call. No dynamic memory is used, the result is
+ * stored inside of it. If the mailbox was full, the call is never run and the future is
+ * dropped() instead of ready().
+ *
+ * @tparam R Result type
+ */
+template <typename R>
+class CallbackFuture : public CallbackFutureState {
+   public:
+    CallbackFuture() = default;
+
+    ~CallbackFuture() { reset(); }
+
+    /**
+     * @brief Wait until the call ran and get its result, the result stays in the future. Only
+     * valid for a call which was posted, see dropped().
+     *
+     * @return R&
+     */
+    R &get() {
+        wait();
+        return *(R *)_storage;
+    }
+
+    /**
+     * @brief Destroy the result, so the future can be used for another call
+     *
+     */
+    void reset() {
+        if (ready()) {
+            ((R *)_storage)->~R();
+        }
+
+        _state.store(idle, std::memory_order_relaxed);
+    }
+
+   private:
+    template <typename, typename, typename...>
+    friend class CallbackMarshalCall;
+
+    alignas(R) unsigned char _storage[sizeof(R)];
+
+    template <typename V>
+    inline void _set(V &&value) {
+        new (_storage) R(std::forward<V>(value));
+        _complete();
+    }
+};
+
+template <>
+class CallbackFuture<void> : public CallbackFutureState {
+   public:
+    CallbackFuture() = default;
+
+    inline void get() const { wait(); }
+
+    inline void reset() { _state.store(idle, std::memory_order_relaxed); }
+
+   private:
+    template <typename, typename, typename...>
+    friend class CallbackMarshalCall;
+
+    inline void _set() { _complete(); }
+};
+
+/**
+ * @brief A call travelling through a mailbox: the Callback, its Arguments (see
+ * CallbackStoredArgument) and the optional future to complete
+ *
+ * @tparam CallbackT
+ * @tparam Return
+ * @tparam ArgTs
+ */
+template <typename CallbackT, typename Return, typename... ArgTs>
+class CallbackMarshalCall {
+   public:
+    template <typename... ValueTs>
+    CallbackMarshalCall(const CallbackT &callback, CallbackFuture<Return> *const future,
+                        ValueTs &&...values)
+        : _callback(callback), _future(future), _arguments(std::forward<ValueTs>(values)...) {}
+
+    inline void operator()() { _run<Return>(std::index_sequence_for<ArgTs...>()); }
+
+   private:
+    CallbackT _callback;
+    CallbackFuture<Return> *_future;
+    std::tuple<typename CallbackStoredArgument<ArgTs>::Type...> _arguments;
+
+    template <typename RN, std::size_t... Indices>
+    inline typename std::enable_if<!std::is_void<RN>::value>::type _run(
+        std::index_sequence<Indices...>) {
+        if (_future != nullptr) {
+            _future->_set(
+                _callback(CallbackStoredArgument<ArgTs>::get(std::get<Indices>(_arguments))...));
+        } else {
+            _callback(CallbackStoredArgument<ArgTs>::get(std::get<Indices>(_arguments))...);
+        }
+    }
+
+    template <typename RN, std::size_t... Indices>
+    inline typename std::enable_if<std::is_void<RN>::value>::type _run(
+        std::index_sequence<Indices...>) {
+        _callback(CallbackStoredArgument<ArgTs>::get(std::get<Indices>(_arguments))...);
+
+        if (_future != nullptr) {
+            _future->_set();
+        }
+    }
+};
+
+/**
+ * @brief Calling it posts the Callback with copies of the Arguments to a mailbox, the owner of
+ * the mailbox calls it on its next drain(). Unlike the Callback returned by InplaceCallback::on(),
+ * post() tells if the call was queued and can complete a CallbackFuture with the result. See
+ * marshalledCallback().
+ *
+ * So the destination (and its cache lines) is only ever touched by the thread or core it belongs
+ * to. Mailbox is any queue of this library holding Callbacks without Arguments which can be
+ * constructed from a Functor taking ownership of it, e.g. CallbackMailbox.
+ *
+ * NOTE: Non-const reference Arguments are not copied, the call gets the object of the caller,
+ * which has to outlive the call (e.g. wait for the future before it is destroyed).
+ *
+ * @tparam Mailbox The queue of the owning thread or core
+ * @tparam CallbackT The marshalled Callback
+ */
+template <typename Mailbox, std::size_t BufferSize, typename R, typename... ArgTs>
+class MarshalledCallback<Mailbox, InplaceCallback<BufferSize, R, ArgTs...>> {
+   public:
+    using CallbackT = InplaceCallback<BufferSize, R, ArgTs...>;
+    using Return = typename CallbackT::Return;
+    using Future = CallbackFuture<Return>;
+
+    MarshalledCallback(Mailbox &mailbox, const CallbackT &callback)
+        : _mailbox(&mailbox), _callback(callback) {}
+
+    /**
+     * @brief Post a call without waiting for it, its result is discarded
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param values Forwarded into the copies held by the mailbox
+     * @return true The call was queued
+     * @return false The mailbox is full
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline bool post(Us &&...values) const {
+        return _mailbox->push(Call(_callback, nullptr, std::forward<Us>(values)...));
+    }
+
+    /**
+     * @brief Post a call which completes future once it ran
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param future Has to outlive the call and must not be pending, reset() it to reuse it
+     * @param values Forwarded into the copies held by the mailbox
+     * @return true The call was queued
+     * @return false The mailbox is full, future is dropped() and never completes
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline bool post(Future &future, Us &&...values) const {
+        future._post();
+
+        if (!_mailbox->push(Call(_callback, &future, std::forward<Us>(values)...))) {
+            future._drop();
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Shorthand for post(values...)
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param values
+     * @return true
+     * @return false
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline bool operator()(Us &&...values) const {
+        return post(std::forward<Us>(values)...);
+    }
+
+    inline Mailbox &mailbox() const { return *_mailbox; }
+
+    inline const CallbackT &callback() const { return _callback; }
+
+   private:
+    using Call = CallbackMarshalCall<CallbackT, Return, ArgTs...>;
+
+    Mailbox *_mailbox;
+    CallbackT _callback;
+};
+
+/**
+ * @brief Create a MarshalledCallback, e.g. to wait for the result of a call on another core
+ *
+ * Usage: CallbackFuture<int> future; marshalledCallback(box, callback).post(future, 42);
+ *
+ * @tparam Mailbox
+ * @tparam BufferSize
+ * @tparam R
+ * @tparam ArgTs
+ * @param mailbox
+ * @param callback
+ * @return MarshalledCallback<Mailbox, InplaceCallback<BufferSize, R, ArgTs...>>
+ */
+template <typename Mailbox, std::size_t BufferSize, typename R, typename... ArgTs>
+MarshalledCallback<Mailbox, InplaceCallback<BufferSize, R, ArgTs...>> marshalledCallback(
+    Mailbox &mailbox, const InplaceCallback<BufferSize, R, ArgTs...> &callback) {
+    return MarshalledCallback<Mailbox, InplaceCallback<BufferSize, R, ArgTs...>>(mailbox, callback);
+}
+
+/**
+ * @brief Caller of a Callback returned by InplaceCallback::on(). Holds the mailbox and the
+ * invoker and buffer of the marshalled Callback, which is posted with the Arguments on each call.
+ *
+ */
+template <std::size_t BufferSize, typename R, typename... ArgTs>
+template <typename Mailbox>
+class InplaceCallback<BufferSize, R, ArgTs...>::MarshalCaller {
+   public:
+    MarshalCaller(Mailbox &mailbox, const Invoker invoker, const Storage &storage)
+        : _mailbox(&mailbox), _invoker(invoker), _storage(storage) {}
+
+    static Return invoke(const void *caller,
+                         CallbackForwardType<ArgTs>... args) noexcept(isNoexcept) {
+        const MarshalCaller *marshalCaller = (const MarshalCaller *)caller;
+
+        if (!marshalCaller->_mailbox->push(
+                CallbackMarshalCall<InplaceCallback<BufferSize, R, ArgTs...>, Return, ArgTs...>(
+                    InplaceCallback<BufferSize, R, ArgTs...>(marshalCaller->_invoker,
+                                                             marshalCaller->_storage),
+                    nullptr, callbackForward<ArgTs>(args)...))) {
+            CALLBACK_MARSHAL_DROPPED();
+        }
+
+        return Return();
+    }
+
+   private:
+    Mailbox *const _mailbox;
+    const Invoker _invoker;
+    const Storage _storage;
+};
+
+/**
+ * @brief Caller of a Callback returned by InplaceCallback::bindOn(), the Method is part of the
+ * type, so only the Object and the mailbox are stored
+ *
+ */
+template <std::size_t BufferSize, typename R, typename... ArgTs>
+template <typename T, typename M, M Method, typename Mailbox>
+class InplaceCallback<BufferSize, R, ArgTs...>::StaticMarshalCaller {
+   public:
+    StaticMarshalCaller(T *const obj, Mailbox &mailbox) : _obj(obj), _mailbox(&mailbox) {}
+
+    static Return invoke(const void *caller,
+                         CallbackForwardType<ArgTs>... args) noexcept(isNoexcept) {
+        const StaticMarshalCaller *marshalCaller = (const StaticMarshalCaller *)caller;
+
+        if (!marshalCaller->_mailbox->push(
+                CallbackMarshalCall<InplaceCallback<BufferSize, R, ArgTs...>, Return, ArgTs...>(
+                    _bindMethod<T, M, Method>(marshalCaller->_obj), nullptr,
+                    callbackForward<ArgTs>(args)...))) {
+            CALLBACK_MARSHAL_DROPPED();
+        }
+
+        return Return();
+    }
+
+   private:
+    T *const _obj;
+    Mailbox *const _mailbox;
+};
@@ -0,0 +1,497 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Callbacks to Functors too big for the internal buffer, stored in fixed-block pools
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "callback.hpp"
+
+// Blocks of each size class of CallbackPoolAllocator
+#ifndef CONFIG_CALLBACK_POOL_BLOCKS
+#ifdef PC_BUILD
+#define CONFIG_CALLBACK_POOL_BLOCKS 64
+#else
+#define CONFIG_CALLBACK_POOL_BLOCKS 4
+#endif
+#endif
+
+// Biggest size class of CallbackPoolAllocator, bigger Functors do not compile
+#ifndef CONFIG_CALLBACK_POOL_MAX_BLOCK_SIZE
+#ifdef PC_BUILD
+#define CONFIG_CALLBACK_POOL_MAX_BLOCK_SIZE 1024   // Byte
+#else
+#define CONFIG_CALLBACK_POOL_MAX_BLOCK_SIZE 128   // Byte
+#endif
+#endif
+
+// Freed blocks each thread keeps for itself before giving them back to the shared free list, 0
+// to always use the shared list (e.g. without thread_local support)
+#ifndef CONFIG_CALLBACK_POOL_THREAD_CACHE
+#ifdef PC_BUILD
+#define CONFIG_CALLBACK_POOL_THREAD_CACHE 8
+#else
+#define CONFIG_CALLBACK_POOL_THREAD_CACHE 0
+#endif
+#endif
+
+/**
+ * @brief Global pool of Blocks fixed size blocks in static memory. Free blocks are kept in a
+ * lock-free stack shared by all threads, in front of which every thread caches a few freed blocks,
+ * so allocating and freeing on the same thread usually touches no shared cache line.
+ *
+ * @tparam BlockSize Size of each block in Byte
+ * @tparam Blocks Amount of blocks, less than 0xFFFF
+ */
+template <std::size_t BlockSize, std::size_t Blocks>
+class CallbackPool {
+    static_assert(Blocks > 0 && Blocks < 0xFFFF, "Blocks have to fit into 16 bit!");
+
+   public:
+    // Alignment every block has
+    static constexpr std::size_t alignment = alignof(std::max_align_t);
+
+    /**
+     * @brief Take a block, O(1)
+     *
+     * @return void* nullptr if the pool is exhausted
+     */
+    static void *allocate() {
+#if CONFIG_CALLBACK_POOL_THREAD_CACHE > 0
+        Cache &cache = _cache();
+
+        if (cache.head != _none) {
+            const uint16_t index = cache.head;
+            cache.head = _next[index].load(std::memory_order_relaxed);
+            cache.count--;
+            return _blocks[index].raw;
+        }
+#endif
+
+        const uint16_t index = _pop();
+        return index == _none ? nullptr : _blocks[index].raw;
+    }
+
+    /**
+     * @brief Give back a block taken by allocate(), may be done from any thread
+     *
+     * @param block
+     */
+    static void deallocate(void *const block) {
+        const uint16_t index = (uint16_t)(((Block *)block) - _blocks);
+
+#if CONFIG_CALLBACK_POOL_THREAD_CACHE > 0
+        Cache &cache = _cache();
+
+        if (cache.count < CONFIG_CALLBACK_POOL_THREAD_CACHE) {
+            _next[index].store(cache.head, std::memory_order_relaxed);
+            cache.head = index;
+            cache.count++;
+            return;
+        }
+#endif
+
+        _push(index);
+    }
+
+    static constexpr std::size_t blockSize() { return BlockSize; }
+    static constexpr std::size_t blocks() { return Blocks; }
+
+   private:
+    static constexpr uint16_t _none = 0xFFFF;
+
+    struct Block {
+        alignas(alignment) uint8_t raw[BlockSize];
+    };
+
+    static Block _blocks[Blocks];
+    static std::atomic<uint16_t> _next[Blocks];
+    static std::atomic<uint32_t> _free;   // Tag << 16 | index of the first free block
+    static std::atomic<uint32_t> _unused;
+
+    static uint16_t _pop() {
+        uint32_t head = _free.load(std::memory_order_acquire);
+
+        while (true) {
+            const uint16_t index = (uint16_t)head;
+
+            if (index == _none) {
+                // No freed block, take one which was never used
+                if (_unused.load(std::memory_order_relaxed) >= Blocks) {
+                    return _none;
+                }
+
+                const uint32_t unused = _unused.fetch_add(1, std::memory_order_relaxed);
+                return unused < Blocks ? (uint16_t)unused : _none;
+            }
+
+            // The tag changes on every pop, see CallbackTargetTable
+            const uint32_t next =
+                ((head >> 16) + 1) << 16 | _next[index].load(std::memory_order_relaxed);
+
+            if (_free.compare_exchange_weak(head, next, std::memory_order_acquire)) {
+                return index;
+            }
+        }
+    }
+
+    static void _push(const uint16_t index) {
+        uint32_t head = _free.load(std::memory_order_relaxed);
+
+        do {
+            _next[index].store((uint16_t)head, std::memory_order_relaxed);
+        } while (!_free.compare_exchange_weak(head, ((head >> 16) + 1) << 16 | index,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+    }
+
+#if CONFIG_CALLBACK_POOL_THREAD_CACHE > 0
+    /**
+     * @brief Blocks cached by one thread, given back to the shared list when the thread exits
+     *
+     */
+    struct Cache {
+        uint16_t head = _none;
+        uint16_t count = 0;
+
+        ~Cache() {
+            while (head != _none) {
+                const uint16_t index = head;
+                head = _next[index].load(std::memory_order_relaxed);
+                _push(index);
+            }
+        }
+    };
+
+    static inline Cache &_cache() {
+        static thread_local Cache cache;
+        return cache;
+    }
+#endif
+};
+
+template <std::size_t BlockSize, std::size_t Blocks>
+typename CallbackPool<BlockSize, Blocks>::Block CallbackPool<BlockSize, Blocks>::_blocks[Blocks];
+
+template <std::size_t BlockSize, std::size_t Blocks>
+std::atomic<uint16_t> CallbackPool<BlockSize, Blocks>::_next[Blocks];
+
+template <std::size_t BlockSize, std::size_t Blocks>
+std::atomic<uint32_t> CallbackPool<BlockSize, Blocks>::_free(
+    CallbackPool<BlockSize, Blocks>::_none);
+
+template <std::size_t BlockSize, std::size_t Blocks>
+std::atomic<uint32_t> CallbackPool<BlockSize, Blocks>::_unused(0);
+
+/**
+ * @brief Smallest power of two size class of at least 32 Byte fitting Size
+ *
+ * @tparam Size
+ * @tparam Class
+ */
+template <std::size_t Size, std::size_t Class = 32, bool Fits = (Size <= Class)>
+struct CallbackPoolSizeClass {
+    static constexpr std::size_t value = CallbackPoolSizeClass<Size, Class * 2>::value;
+};
+
+template <std::size_t Size, std::size_t Class>
+struct CallbackPoolSizeClass<Size, Class, true> {
+    static constexpr std::size_t value = Class;
+};
+
+/**
+ * @brief Default allocator of PooledCallback, a CallbackPool per power of two size class, the
+ * class is picked at compile time
+ *
+ * Own allocators (e.g. an arena) need the same two static functions. allocate() returns nullptr
+ * if nothing is left.
+ */
+struct CallbackPoolAllocator {
+    template <std::size_t Size>
+    using Pool = CallbackPool<CallbackPoolSizeClass<Size>::value, CONFIG_CALLBACK_POOL_BLOCKS>;
+
+    template <std::size_t Size, std::size_t Align>
+    static inline void *allocate() {
+        static_assert(Size <= CONFIG_CALLBACK_POOL_MAX_BLOCK_SIZE,
+                      "Functor is bigger than CONFIG_CALLBACK_POOL_MAX_BLOCK_SIZE!");
+        static_assert(Align <= Pool<Size>::alignment, "Functor alignment is too big!");
+
+        return Pool<Size>::allocate();
+    }
+
+    template <std::size_t Size, std::size_t Align>
+    static inline void deallocate(void *const block) {
+        Pool<Size>::deallocate(block);
+    }
+};
+
+/**
+ * @brief Functor calling another Functor through a pointer, so a Callback to a Functor stored
+ * elsewhere fits any buffer
+ *
+ * @tparam F
+ */
+template <typename F>
+class CallbackFunctorRef {
+   public:
+    constexpr CallbackFunctorRef(const F *const functor) : _functor(functor) {}
+
+    template <typename... ArgTs>
+    inline auto operator()(ArgTs &&...args) const
+        noexcept(noexcept(std::declval<const F &>()(std::forward<ArgTs>(args)...)))
+            -> decltype(std::declval<const F &>()(std::forward<ArgTs>(args)...)) {
+        return (*_functor)(std::forward<ArgTs>(args)...);
+    }
+
+   private:
+    const F *_functor;
+};
+
+/**
+ * @brief A Callback owning its destination: Functors fitting the internal buffer are stored in
+ * it like in Callback, bigger ones (or ones which are not trivially copyable) in a block of
+ * Allocator. Copying copies the Functor into a new block.
+ *
+ * If the Allocator is exhausted the PooledCallback is empty (see isCallbackSet()).
+ *
+ * @tparam Allocator See CallbackPoolAllocator
+ * @tparam R Return type, may be CallbackNoexcept<R>
+ * @tparam ArgTs Optional Arguments
+ */
+template <typename Allocator, typename R, typename... ArgTs>
+class AllocatedCallback {
+   public:
+    using Inner = Callback<R, ArgTs...>;
+    using Return = typename Inner::Return;
+
+    AllocatedCallback() : _callback(), _block(nullptr), _ops(nullptr) {}
+
+    /**
+     * @brief Wrap a Callback, nothing is allocated
+     *
+     * @param callback
+     */
+    AllocatedCallback(const Inner &callback)
+        : _callback(callback), _block(nullptr), _ops(nullptr) {}
+
+    /**
+     * @brief Store a Functor, in a block of the Allocator if it does not fit into a Callback
+     *
+     * @tparam F
+     * @param functor Has to be callable as const
+     */
+    template <typename F, typename D = typename std::decay<F>::type,
+              typename = typename std::enable_if<
+                  std::is_class<D>::value && !std::is_base_of<AllocatedCallback, D>::value &&
+                  !std::is_same<Inner, D>::value &&
+                  std::is_constructible<Inner, CallbackFunctorRef<D>>::value>::type>
+    AllocatedCallback(F &&functor) : _callback(), _block(nullptr), _ops(nullptr) {
+        _store<D>(std::forward<F>(functor), std::integral_constant<bool, _fitsInline<D>()>());
+    }
+
+    AllocatedCallback(const AllocatedCallback &other)
+        : _callback(other._callback), _block(nullptr), _ops(nullptr) {
+        if (other._block != nullptr) {
+            _copyFrom(other);
+        }
+    }
+
+    AllocatedCallback(AllocatedCallback &&other) noexcept
+        : _callback(other._callback), _block(other._block), _ops(other._ops) {
+        other._release();
+    }
+
+    ~AllocatedCallback() { _destroy(); }
+
+    AllocatedCallback &operator=(const AllocatedCallback &other) {
+        if (this != &other) {
+            _destroy();
+            _callback = other._callback;
+
+            if (other._block != nullptr) {
+                _copyFrom(other);
+            }
+        }
+
+        return *this;
+    }
+
+    AllocatedCallback &operator=(AllocatedCallback &&other) noexcept {
+        if (this != &other) {
+            _destroy();
+            _callback = other._callback;
+            _block = other._block;
+            _ops = other._ops;
+            other._release();
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Call the Callback. The values are forwarded, so a by-value Argument is only
+     * constructed once, see CallbackForwardType.
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param values
+     * @return Return
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline Return call(Us &&...values) const
+        noexcept(noexcept(std::declval<const Inner &>().call(std::forward<Us>(values)...))) {
+        return _callback.call(std::forward<Us>(values)...);
+    }
+
+    /**
+     * @brief Shorthand for call()
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param values
+     * @return Return
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline Return operator()(Us &&...values) const
+        noexcept(noexcept(std::declval<const Inner &>().call(std::forward<Us>(values)...))) {
+        return _callback.call(std::forward<Us>(values)...);
+    }
+
+    /**
+     * @brief Get a plain Callback to the destination, to pass it on. It points into the block, so
+     * it is only valid as long as this AllocatedCallback exists.
+     *
+     * @return const Inner&
+     */
+    inline const Inner &callback() const { return _callback; }
+
+    inline bool isCallbackSet() const { return _callback.isCallbackSet(); }
+
+    /**
+     * @brief Check if the Functor is stored in a block of the Allocator
+     *
+     * @return true
+     * @return false
+     */
+    inline bool isAllocated() const { return _block != nullptr; }
+
+   private:
+    /**
+     * @brief What needs to be known about a Functor stored in a block
+     *
+     */
+    struct Ops {
+        void *(*copy)(const void *block);
+        void (*destroy)(void *block);
+        Inner (*bind)(const void *block);
+    };
+
+    template <typename F>
+    struct Allocated {
+        static void *copy(const void *const block) {
+            void *const copy = Allocator::template allocate<sizeof(F), alignof(F)>();
+
+            if (copy != nullptr) {
+                new (copy) F(*(const F *)block);
+            }
+
+            return copy;
+        }
+
+        static void destroy(void *const block) {
+            ((F *)block)->~F();
+            Allocator::template deallocate<sizeof(F), alignof(F)>(block);
+        }
+
+        static Inner bind(const void *const block) {
+            return Inner(CallbackFunctorRef<F>((const F *)block));
+        }
+
+        static const Ops ops;
+    };
+
+    Inner _callback;
+    void *_block;
+    const Ops *_ops;
+
+    template <typename F>
+    static constexpr bool _fitsInline() {
+        return sizeof(F) <= CALLBACK_INTERNAL_BUFFER_SIZE && alignof(F) <= alignof(void *) &&
+               std::is_trivially_copyable<F>::value && std::is_trivially_destructible<F>::value;
+    }
+
+    template <typename F, typename G>
+    inline void _store(G &&functor, std::true_type) {
+        _callback = Inner(F(std::forward<G>(functor)));
+    }
+
+    template <typename F, typename G>
+    void _store(G &&functor, std::false_type) {
+        void *const block = Allocator::template allocate<sizeof(F), alignof(F)>();
+
+        if (block == nullptr) {
+            return;
+        }
+
+        new (block) F(std::forward<G>(functor));
+        _block = block;
+        _ops = &Allocated<F>::ops;
+        _callback = Allocated<F>::bind(block);
+    }
+
+    void _copyFrom(const AllocatedCallback &other) {
+        _block = other._ops->copy(other._block);
+
+        if (_block == nullptr) {
+            _callback = Inner();
+            return;
+        }
+
+        _ops = other._ops;
+        _callback = _ops->bind(_block);
+    }
+
+    inline void _release() {
+        _callback = Inner();
+        _block = nullptr;
+        _ops = nullptr;
+    }
+
+    void _destroy() {
+        if (_block != nullptr) {
+            _ops->destroy(_block);
+        }
+
+        _release();
+    }
+};
+
+template <typename Allocator, typename R, typename... ArgTs>
+template <typename F>
+const typename AllocatedCallback<Allocator, R, ArgTs...>::Ops
+    AllocatedCallback<Allocator, R, ArgTs...>::Allocated<F>::ops = {
+        &AllocatedCallback<Allocator, R, ArgTs...>::Allocated<F>::copy,
+        &AllocatedCallback<Allocator, R, ArgTs...>::Allocated<F>::destroy,
+        &AllocatedCallback<Allocator, R, ArgTs...>::Allocated<F>::bind};
+
+/**
+ * @brief AllocatedCallback using the global CallbackPools
+ *
+ * Usage: PooledCallback<void> onDone = [big = std::array<uint8_t, 200>()]() { ... };
+ *
+ * @tparam R Return type
+ * @tparam ArgTs Optional Arguments
+ */
+template <typename R, typename... ArgTs>
+using PooledCallback = AllocatedCallback<CallbackPoolAllocator, R, ArgTs...>;
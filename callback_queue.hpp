@@ -0,0 +1,458 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Fixed capacity queues of deferred Callbacks, e.g. to post work from an ISR to a main loop
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "callback.hpp"
+
+// Alignment to keep the producer and consumer side of a queue apart
+#ifndef CALLBACK_CACHE_LINE_SIZE
+#ifdef PC_BUILD
+#define CALLBACK_CACHE_LINE_SIZE 64   // Byte
+#else
+#define CALLBACK_CACHE_LINE_SIZE sizeof(void *)
+#endif
+#endif
+
+/**
+ * @brief How a queued call stores an Argument until it runs. Values and const references are
+ * stored as decayed copies, non-const lvalue references as std::reference_wrapper, so the
+ * Callback changes the object of the caller and not a copy. That object has to outlive the call.
+ *
+ * @tparam T Argument type as given to the Callback
+ */
+template <typename T>
+struct CallbackStoredArgument {
+    using Type = typename std::decay<T>::type;
+
+    static inline T &&get(Type &value) { return std::forward<T>(value); }
+};
+
+template <typename T>
+struct CallbackStoredArgument<T &> {
+    using Type = std::reference_wrapper<T>;
+
+    static inline T &get(Type &value) { return value.get(); }
+};
+
+template <typename T>
+struct CallbackStoredArgument<const T &> {
+    using Type = typename std::decay<T>::type;
+
+    static inline const T &get(Type &value) { return value; }
+};
+
+/**
+ * @brief A Callback together with the Arguments it will be called with, see
+ * CallbackStoredArgument
+ *
+ * @tparam CallbackT The type of the Callback
+ * @tparam ArgTs Arguments of the Callback
+ */
+template <typename CallbackT, typename... ArgTs>
+class CallbackQueueCall {
+   public:
+    template <typename... ValueTs>
+    CallbackQueueCall(CallbackT callback, ValueTs &&...values)
+        : _callback(std::move(callback)), _arguments(std::forward<ValueTs>(values)...) {}
+
+    /**
+     * @brief Call the Callback with the stored Arguments. Can only be done once, as the Arguments
+     * are moved into the Callback.
+     *
+     */
+    inline void run() { _run(std::index_sequence_for<ArgTs...>()); }
+
+   private:
+    CallbackT _callback;
+    std::tuple<typename CallbackStoredArgument<ArgTs>::Type...> _arguments;
+
+    template <std::size_t... Indices>
+    inline void _run(std::index_sequence<Indices...>) {
+        _callback(CallbackStoredArgument<ArgTs>::get(std::get<Indices>(_arguments))...);
+    }
+};
+
+/**
+ * @brief A queued Callback together with copies of the Arguments it will be called with
+ *
+ * @tparam CallbackT The type of the Callback
+ */
+template <typename CallbackT>
+class CallbackQueueEntry;
+
+template <std::size_t BufferSize, typename R, typename... ArgTs>
+class CallbackQueueEntry<InplaceCallback<BufferSize, R, ArgTs...>>
+    : public CallbackQueueCall<InplaceCallback<BufferSize, R, ArgTs...>, ArgTs...> {
+   public:
+    using CallbackQueueCall<InplaceCallback<BufferSize, R, ArgTs...>, ArgTs...>::CallbackQueueCall;
+};
+
+template <std::size_t BufferSize, typename R, typename... ArgTs>
+class InplaceUniqueCallback;
+
+// Move-only Callbacks (see callback_unique.hpp) are moved through the queue
+template <std::size_t BufferSize, typename R, typename... ArgTs>
+class CallbackQueueEntry<InplaceUniqueCallback<BufferSize, R, ArgTs...>>
+    : public CallbackQueueCall<InplaceUniqueCallback<BufferSize, R, ArgTs...>, ArgTs...> {
+   public:
+    using CallbackQueueCall<InplaceUniqueCallback<BufferSize, R, ArgTs...>,
+                            ArgTs...>::CallbackQueueCall;
+};
+
+/**
+ * @brief Raw storage for one Entry of a queue, the Entry is constructed on push and destroyed
+ * after it ran
+ *
+ * @tparam Entry
+ */
+template <typename Entry>
+struct CallbackQueueSlot {
+    alignas(Entry) unsigned char raw[sizeof(Entry)];
+
+    inline Entry *entry() { return (Entry *)raw; }
+};
+
+/**
+ * @brief Wait-free single producer, single consumer queue of Callbacks
+ *
+ * One context (e.g. an ISR) push()es, another one (e.g. the main loop) drain()s. Pushing never
+ * waits and never allocates.
+ *
+ * @tparam Capacity Maximum amount of queued Callbacks, has to be a power of two
+ * @tparam CallbackT The type of the queued Callbacks, its Arguments are stored with it
+ */
+template <std::size_t Capacity, typename CallbackT = Callback<void>>
+class CallbackQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity has to be a power of two!");
+
+   public:
+    CallbackQueue() : _head(0), _tail(0) {}
+
+    CallbackQueue(const CallbackQueue &) = delete;
+    CallbackQueue &operator=(const CallbackQueue &) = delete;
+
+    ~CallbackQueue() {
+        std::size_t head = _head.load(std::memory_order_relaxed);
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+
+        for (; head != tail; head++) {
+            _slots[head & (Capacity - 1)].entry()->~Entry();
+        }
+    }
+
+    /**
+     * @brief Queue a Callback, only call this from the single producer
+     *
+     * @param callback The Callback (or what it is constructed from) to be called on drain(), only
+     * moved from if it was queued
+     * @param values The Arguments the Callback will be called with, the objects of non-const
+     * reference Arguments are referenced and have to outlive the call
+     * @return true Callback was queued
+     * @return false Queue is full
+     */
+    template <typename C, typename... ValueTs>
+    bool push(C &&callback, ValueTs &&...values) {
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+
+        if (tail - _head.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+
+        new (_slots[tail & (Capacity - 1)].raw)
+            Entry(std::forward<C>(callback), std::forward<ValueTs>(values)...);
+        _tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief Call the queued Callbacks in the order they were pushed, only call this from the
+     * single consumer. Callbacks pushed while draining are called on the next drain().
+     *
+     * @param maxCount Maximum amount of Callbacks to call
+     * @return std::size_t Amount of called Callbacks
+     */
+    std::size_t drain(const std::size_t maxCount = Capacity) {
+        std::size_t head = _head.load(std::memory_order_relaxed);
+        const std::size_t tail = _tail.load(std::memory_order_acquire);
+        std::size_t count = 0;
+
+        for (; head != tail && count < maxCount; count++) {
+            Entry *entry = _slots[head & (Capacity - 1)].entry();
+            entry->run();
+            entry->~Entry();
+
+            _head.store(++head, std::memory_order_release);
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Check if nothing is queued
+     *
+     * @return true
+     * @return false
+     */
+    inline bool empty() const {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+   private:
+    using Entry = CallbackQueueEntry<CallbackT>;
+
+    CallbackQueueSlot<Entry> _slots[Capacity];
+    alignas(CALLBACK_CACHE_LINE_SIZE) std::atomic<std::size_t> _head;
+    alignas(CALLBACK_CACHE_LINE_SIZE) std::atomic<std::size_t> _tail;
+};
+
+/**
+ * @brief Producer side shared by MpscCallbackQueue and MpmcCallbackQueue: a ring of slots whose
+ * sequence numbers tell if a slot is free for the push of a position or ready to be drained
+ * (bounded MPMC queue by Dmitry Vyukov). A push claims a position with a CAS on the tail and
+ * publishes its Entry by advancing the sequence of the slot.
+ *
+ * @tparam Capacity Maximum amount of queued Callbacks, has to be a power of two
+ * @tparam CallbackT The type of the queued Callbacks, its Arguments are stored with it
+ */
+template <std::size_t Capacity, typename CallbackT>
+class CallbackSequencedQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity has to be a power of two!");
+
+   public:
+    CallbackSequencedQueue(const CallbackSequencedQueue &) = delete;
+    CallbackSequencedQueue &operator=(const CallbackSequencedQueue &) = delete;
+
+    /**
+     * @brief Queue a Callback, can be called from any context
+     *
+     * @param callback The Callback (or what it is constructed from) to be called on drain(), only
+     * moved from if it was queued
+     * @param values The Arguments the Callback will be called with, the objects of non-const
+     * reference Arguments are referenced and have to outlive the call
+     * @return true Callback was queued
+     * @return false Queue is full
+     */
+    template <typename C, typename... ValueTs>
+    bool push(C &&callback, ValueTs &&...values) {
+        std::size_t position = _tail.load(std::memory_order_relaxed);
+        Slot *slot;
+
+        while (true) {
+            slot = &_slots[position & (Capacity - 1)];
+            const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+            if (difference == 0) {
+                // Slot is free, try to claim it
+                if (_tail.compare_exchange_weak(position, position + 1,
+                                                std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                // Slot still holds the Entry of the last round
+                return false;
+            } else {
+                position = _tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (slot->raw) Entry(std::forward<C>(callback), std::forward<ValueTs>(values)...);
+        slot->sequence.store(position + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+   protected:
+    using Entry = CallbackQueueEntry<CallbackT>;
+
+    struct Slot : public CallbackQueueSlot<Entry> {
+        std::atomic<std::size_t> sequence;
+    };
+
+    Slot _slots[Capacity];
+    alignas(CALLBACK_CACHE_LINE_SIZE) std::atomic<std::size_t> _tail;
+
+    CallbackSequencedQueue() : _tail(0) {
+        for (std::size_t i = 0; i < Capacity; i++) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~CallbackSequencedQueue() = default;
+
+    /**
+     * @brief Check if the Entry of a position was pushed and not drained yet
+     *
+     * @param position
+     * @return true
+     * @return false
+     */
+    inline bool _isReady(const std::size_t position) const {
+        return _slots[position & (Capacity - 1)].sequence.load(std::memory_order_acquire) ==
+               position + 1;
+    }
+};
+
+/**
+ * @brief Lock-free multi producer, single consumer queue of Callbacks
+ *
+ * Any amount of contexts (threads, ISRs) may push(), one context drain()s. A push never waits for
+ * another one; if a push got interrupted half way, drain() stops in front of it until it is
+ * finished.
+ *
+ * @tparam Capacity Maximum amount of queued Callbacks, has to be a power of two
+ * @tparam CallbackT The type of the queued Callbacks, its Arguments are stored with it
+ */
+template <std::size_t Capacity, typename CallbackT = Callback<void>>
+class MpscCallbackQueue : public CallbackSequencedQueue<Capacity, CallbackT> {
+    using Base = CallbackSequencedQueue<Capacity, CallbackT>;
+    using typename Base::Entry;
+    using typename Base::Slot;
+    using Base::_isReady;
+    using Base::_slots;
+
+   public:
+    MpscCallbackQueue() : _head(0) {}
+
+    ~MpscCallbackQueue() {
+        for (; _isReady(_head); _head++) {
+            _slots[_head & (Capacity - 1)].entry()->~Entry();
+        }
+    }
+
+    /**
+     * @brief Call the queued Callbacks in the order they were pushed, only call this from the
+     * single consumer
+     *
+     * @param maxCount Maximum amount of Callbacks to call
+     * @return std::size_t Amount of called Callbacks
+     */
+    std::size_t drain(const std::size_t maxCount = Capacity) {
+        std::size_t count = 0;
+
+        for (; count < maxCount && _isReady(_head); count++) {
+            Slot &slot = _slots[_head & (Capacity - 1)];
+            slot.entry()->run();
+            slot.entry()->~Entry();
+
+            slot.sequence.store(_head + Capacity, std::memory_order_release);
+            _head++;
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Check if nothing is ready to be drained, only call this from the single consumer
+     *
+     * @return true
+     * @return false
+     */
+    inline bool empty() const { return !_isReady(_head); }
+
+   private:
+    alignas(CALLBACK_CACHE_LINE_SIZE) std::size_t _head;   // Only used by the consumer
+};
+
+/**
+ * @brief Lock-free multi producer, multi consumer queue of Callbacks
+ *
+ * Any amount of contexts may push() and drain(). Each Entry is moved out of its slot before it is
+ * called, so a long running Callback does not keep its slot from being reused.
+ *
+ * @tparam Capacity Maximum amount of queued Callbacks, has to be a power of two
+ * @tparam CallbackT The type of the queued Callbacks, its Arguments are stored with it
+ */
+template <std::size_t Capacity, typename CallbackT = Callback<void>>
+class MpmcCallbackQueue : public CallbackSequencedQueue<Capacity, CallbackT> {
+    using Base = CallbackSequencedQueue<Capacity, CallbackT>;
+    using typename Base::Entry;
+    using typename Base::Slot;
+    using Base::_isReady;
+    using Base::_slots;
+
+   public:
+    MpmcCallbackQueue() : _head(0) {}
+
+    ~MpmcCallbackQueue() {
+        std::size_t head = _head.load(std::memory_order_relaxed);
+
+        for (; _isReady(head); head++) {
+            _slots[head & (Capacity - 1)].entry()->~Entry();
+        }
+    }
+
+    /**
+     * @brief Call queued Callbacks in the order they were pushed, can be called from any context.
+     * Concurrent drain()s call different Callbacks.
+     *
+     * @param maxCount Maximum amount of Callbacks to call
+     * @return std::size_t Amount of called Callbacks
+     */
+    std::size_t drain(const std::size_t maxCount = Capacity) {
+        std::size_t count = 0;
+
+        for (; count < maxCount; count++) {
+            std::size_t position = _head.load(std::memory_order_relaxed);
+            Slot *slot;
+
+            while (true) {
+                slot = &_slots[position & (Capacity - 1)];
+                const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                const intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+
+                if (difference == 0) {
+                    if (_head.compare_exchange_weak(position, position + 1,
+                                                    std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (difference < 0) {
+                    return count;
+                } else {
+                    position = _head.load(std::memory_order_relaxed);
+                }
+            }
+
+            Entry entry(std::move(*slot->entry()));
+            slot->entry()->~Entry();
+            slot->sequence.store(position + Capacity, std::memory_order_release);
+
+            entry.run();
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Check if nothing is ready to be drained, only a snapshot while others push or drain
+     *
+     * @return true
+     * @return false
+     */
+    inline bool empty() const { return !_isReady(_head.load(std::memory_order_relaxed)); }
+
+   private:
+    alignas(CALLBACK_CACHE_LINE_SIZE) std::atomic<std::size_t> _head;
+};
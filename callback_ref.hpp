@@ -0,0 +1,229 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Non-owning reference to anything callable, to pass visitors and comparators for free
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "callback.hpp"
+
+/**
+ * @brief Two pointers referencing a Function, a Method bound at compile time, a Functor or an
+ * existing Callback, without copying it (like function_ref)
+ *
+ * Meant as parameter of functions calling it synchronously, e.g. forEach(CallbackRef<void, int>).
+ * Constructing it only takes two pointers and, as the invoker is known at the call site, the call
+ * can be inlined if the callee is visible. A referenced Functor has to outlive the CallbackRef, a
+ * temporary lives until the end of the call it is passed to.
+ *
+ * Methods known at compile time are bound with bind(), Methods given at runtime are referenced
+ * through a CallbackRefMethod, see callbackRefMethod().
+ *
+ * @tparam R Return type
+ * @tparam ArgTs Optional Arguments
+ */
+template <typename R, typename... ArgTs>
+class CallbackRef {
+   public:
+    using Function = R (*)(ArgTs...);
+
+    /**
+     * @brief Reference a Function, nullptr references a no-op returning R()
+     *
+     * @param func
+     */
+    constexpr CallbackRef(const Function func)
+        : _invoker(func != nullptr ? &FunctionCaller::invoke : &NullCaller::invoke),
+          _target(func) {}
+
+    /**
+     * @brief Reference a Functor, a Lambda or a Callback, callable as const
+     *
+     * @tparam F
+     * @param functor
+     */
+    template <typename F,
+              typename = typename std::enable_if<
+                  std::is_class<F>::value && !std::is_same<F, CallbackRef>::value &&
+                  CallbackIsInvocable<F, R, ArgTs...>::value>::type>
+    constexpr CallbackRef(const F &functor)
+        : _invoker(&FunctorCaller<F>::invoke), _target((const void *)&functor) {}
+
+    /**
+     * @brief Reference a Method of an Object, the Method is part of the invoker
+     *
+     * Usage: CallbackRef<void, int>::bind<Visitor, &Visitor::visit>(&visitor)
+     *
+     * @tparam T
+     * @tparam Method
+     * @param obj
+     * @return CallbackRef
+     */
+    template <typename T, R (T::*Method)(ArgTs...)>
+    static constexpr CallbackRef bind(T *const obj) {
+        return CallbackRef(&MethodCaller<T, decltype(Method), Method>::invoke, (const void *)obj);
+    }
+
+    template <typename T, R (T::*Method)(ArgTs...) const>
+    static constexpr CallbackRef bind(const T *const obj) {
+        return CallbackRef(&MethodCaller<const T, decltype(Method), Method>::invoke,
+                           (const void *)obj);
+    }
+
+#ifdef __cpp_nontype_template_parameter_auto
+    /**
+     * @brief Reference a Method of an Object, with any qualifiers callable on T (C++17)
+     *
+     * Usage: CallbackRef<void, int>::bind<&Visitor::visit>(&visitor)
+     *
+     * @tparam Method
+     * @tparam T
+     * @param obj
+     * @return CallbackRef
+     */
+    template <auto Method, typename T>
+    static constexpr CallbackRef bind(T *const obj) {
+        static_assert(CallbackIsMethodInvocable<T, decltype(Method), R, ArgTs...>::value,
+                      "Method can not be called on the Object with the Arguments of the Callback!");
+
+        return CallbackRef(&MethodCaller<T, decltype(Method), Method>::invoke, (const void *)obj);
+    }
+#endif
+
+    /**
+     * @brief Call the referenced destination. The values are forwarded, so a by-value Argument is
+     * only constructed once, see CallbackForwardType.
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param values
+     * @return R
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline R call(Us &&...values) const {
+        return _invoker(_target, std::forward<Us>(values)...);
+    }
+
+    /**
+     * @brief Shorthand for call()
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param values
+     * @return R
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline R operator()(Us &&...values) const {
+        return _invoker(_target, std::forward<Us>(values)...);
+    }
+
+   private:
+    /**
+     * @brief What is referenced, Function pointers can not be stored as void *
+     *
+     */
+    union Target {
+        constexpr Target(const Function func) : function(func) {}
+        constexpr Target(const void *const obj) : object(obj) {}
+
+        Function function;
+        const void *object;
+    };
+
+    using Invoker = R (*)(const Target target, CallbackForwardType<ArgTs>... args);
+
+    Invoker _invoker;
+    Target _target;
+
+    constexpr CallbackRef(const Invoker invoker, const void *const obj)
+        : _invoker(invoker), _target(obj) {}
+
+    class NullCaller {
+       public:
+        static R invoke(const Target, CallbackForwardType<ArgTs>...) { return R(); }
+    };
+
+    class FunctionCaller {
+       public:
+        static R invoke(const Target target, CallbackForwardType<ArgTs>... args) {
+            return (*target.function)(callbackForward<ArgTs>(args)...);
+        }
+    };
+
+    template <typename F>
+    class FunctorCaller {
+       public:
+        static R invoke(const Target target, CallbackForwardType<ArgTs>... args) {
+            return static_cast<R>((*(const F *)target.object)(callbackForward<ArgTs>(args)...));
+        }
+    };
+
+    template <typename T, typename M, M Method>
+    class MethodCaller {
+       public:
+        static R invoke(const Target target, CallbackForwardType<ArgTs>... args) {
+            return static_cast<R>((*(T *)target.object.*Method)(callbackForward<ArgTs>(args)...));
+        }
+    };
+};
+
+/**
+ * @brief An Object together with a Method given at runtime, for a CallbackRef to reference. A
+ * CallbackRef only holds two pointers, which leaves no room for the Method pointer, so it is held
+ * here and has to outlive the CallbackRef like any referenced Functor. A temporary passed to a
+ * function taking a CallbackRef lives until the end of the call.
+ *
+ * @tparam T Type of the Object, including its const / volatile qualifiers
+ * @tparam M Method (-pointer) type
+ */
+template <typename T, typename M>
+class CallbackRefMethod {
+   public:
+    constexpr CallbackRefMethod(T *const obj, const M method) : _obj(obj), _method(method) {}
+
+    template <typename... Us>
+    auto operator()(Us &&...values) const
+        -> decltype((std::declval<T &>().*std::declval<M>())(std::forward<Us>(values)...)) {
+        return (*_obj.*_method)(std::forward<Us>(values)...);
+    }
+
+   private:
+    T *const _obj;
+    const M _method;
+};
+
+/**
+ * @brief Reference a Method given at runtime, e.g. chosen from a table
+ *
+ * Usage: forEach(callbackRefMethod(&visitor, &Visitor::visit));
+ *
+ * @tparam T
+ * @tparam M Method (-pointer) type, may be const / volatile / & qualified and noexcept
+ * @param obj Must not be nullptr
+ * @param method Must not be nullptr
+ * @return constexpr CallbackRefMethod<T, M>
+ */
+template <typename T, typename M>
+constexpr CallbackRefMethod<T, M> callbackRefMethod(T *const obj, const M method) {
+    return CallbackRefMethod<T, M>(obj, method);
+}
+
+/**
+ * @brief Reference a Method given at runtime
+ *
+ * @tparam T
+ * @tparam M Method (-pointer) type, may be const / volatile / & qualified and noexcept
+ * @param obj
+ * @param method Must not be nullptr
+ * @return constexpr CallbackRefMethod<T, M>
+ */
+template <typename T, typename M>
+constexpr CallbackRefMethod<T, M> callbackRefMethod(T &obj, const M method) {
+    return CallbackRefMethod<T, M>(&obj, method);
+}
@@ -0,0 +1,206 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Integer handles to Callbacks, resolved per process, e.g. to dispatch over shared memory
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <type_traits>
+#include <utility>
+
+#include "callback.hpp"
+
+/**
+ * @brief Id of a Callback in a CallbackRegistry
+ *
+ * A Callback holds addresses (and a vptr) which differ between processes, a handle is only an
+ * integer and means the same in every process registering the same ids. So it can be put into
+ * shared memory or sent to another process.
+ *
+ */
+struct CallbackHandle {
+    static constexpr uint32_t invalidId = UINT32_MAX;
+
+    constexpr CallbackHandle() : id(invalidId) {}
+
+    constexpr explicit CallbackHandle(const uint32_t id) : id(id) {}
+
+    constexpr bool isValid() const { return id != invalidId; }
+
+    constexpr bool operator==(const CallbackHandle &other) const { return id == other.id; }
+
+    constexpr bool operator!=(const CallbackHandle &other) const { return id != other.id; }
+
+    uint32_t id;
+};
+
+static_assert(std::is_trivially_copyable<CallbackHandle>::value &&
+                  std::is_standard_layout<CallbackHandle>::value && sizeof(CallbackHandle) == 4,
+              "CallbackHandle has to be a plain 4 Byte value!");
+
+/**
+ * @brief A handle together with copies of the Arguments to call it with, a plain value which can
+ * be written into a shared memory ring buffer
+ *
+ * @tparam ArgTs Arguments of the Callback, decayed copies are stored and have to be trivially
+ * copyable
+ */
+template <typename... ArgTs>
+struct CallbackHandleCall {
+    using Arguments =
+        CallbackValues<std::index_sequence_for<ArgTs...>, typename std::decay<ArgTs>::type...>;
+
+    static_assert(std::is_trivially_copyable<Arguments>::value,
+                  "Arguments have to be trivially copyable!");
+
+    constexpr CallbackHandleCall() : handle(), arguments(typename std::decay<ArgTs>::type()...) {}
+
+    template <typename... ValueTs>
+    constexpr CallbackHandleCall(const CallbackHandle handle, ValueTs &&...values)
+        : handle(handle), arguments(std::forward<ValueTs>(values)...) {}
+
+    CallbackHandle handle;
+    Arguments arguments;
+};
+
+/**
+ * @brief Table of the Callbacks of one process, resolving CallbackHandles in O(1)
+ *
+ * Every process creates its own registry and registers its local Callbacks under ids all
+ * processes agree on (e.g. an enum) with set(), or with add() if all of them register in the same
+ * order. Dispatching is a bounds check and an indexed call, unknown handles call an empty
+ * Callback.
+ *
+ * NOTE: Registering is not synchronized with dispatching, register before handles are
+ * dispatched. Use AtomicCallbackSlot (see callback_atomic.hpp) as destination to rebind later.
+ *
+ * @tparam Capacity Maximum amount of Callbacks, ids are 0 to Capacity - 1
+ * @tparam R Return type
+ * @tparam ArgTs Optional Arguments
+ */
+template <std::size_t Capacity, typename R, typename... ArgTs>
+class CallbackRegistry {
+    static_assert(Capacity > 0 && Capacity < CallbackHandle::invalidId,
+                  "Capacity has to fit the ids of CallbackHandle!");
+
+   public:
+    using CallbackT = Callback<R, ArgTs...>;
+    using Return = typename CallbackT::Return;
+    using Call = CallbackHandleCall<ArgTs...>;
+
+    /**
+     * @brief Register a Callback under the lowest free id
+     *
+     * @param callback
+     * @return CallbackHandle Invalid if the registry is full or the Callback is empty
+     */
+    CallbackHandle add(const CallbackT &callback) {
+        if (!callback.isCallbackSet()) {
+            return CallbackHandle();
+        }
+
+        for (std::size_t i = 0; i < Capacity; i++) {
+            if (!_callbacks[i].isCallbackSet()) {
+                _callbacks[i] = callback;
+                return CallbackHandle((uint32_t)i);
+            }
+        }
+
+        return CallbackHandle();
+    }
+
+    /**
+     * @brief Register a Callback under a given id, replacing the one registered before
+     *
+     * @param handle
+     * @param callback An empty Callback removes the handle
+     * @return true
+     * @return false The id is out of range
+     */
+    bool set(const CallbackHandle handle, const CallbackT &callback) {
+        if (handle.id >= Capacity) {
+            return false;
+        }
+
+        _callbacks[handle.id] = callback;
+        return true;
+    }
+
+    inline void remove(const CallbackHandle handle) { set(handle, CallbackT()); }
+
+    /**
+     * @brief Check if a Callback is registered under a handle
+     *
+     * @param handle
+     * @return true
+     * @return false
+     */
+    inline bool contains(const CallbackHandle handle) const {
+        return handle.id < Capacity && _callbacks[handle.id].isCallbackSet();
+    }
+
+    /**
+     * @brief Get the Callback of a handle, an empty one if it has none
+     *
+     * @param handle
+     * @return const CallbackT&
+     */
+    inline const CallbackT &resolve(const CallbackHandle handle) const {
+        return _callbacks[handle.id < Capacity ? handle.id : Capacity];
+    }
+
+    /**
+     * @brief Call the Callback of a handle. The values are forwarded, so a by-value Argument is
+     * only constructed once, see CallbackForwardType.
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param handle
+     * @param values
+     * @return Return
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline Return dispatch(const CallbackHandle handle, Us &&...values) const {
+        return resolve(handle).call(std::forward<Us>(values)...);
+    }
+
+    /**
+     * @brief Call the Callback of a handle with the Arguments stored with it
+     *
+     * @param call
+     * @return Return
+     */
+    inline Return dispatch(const Call &call) const {
+        return _dispatch(call, std::index_sequence_for<ArgTs...>());
+    }
+
+    /**
+     * @brief Shorthand for dispatch()
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param handle
+     * @param values
+     * @return Return
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline Return operator()(const CallbackHandle handle, Us &&...values) const {
+        return dispatch(handle, std::forward<Us>(values)...);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+   private:
+    // Registered Callbacks, followed by an empty one for unknown handles
+    CallbackT _callbacks[Capacity + 1];
+
+    template <std::size_t... Indices>
+    inline Return _dispatch(const Call &call, std::index_sequence<Indices...>) const {
+        return resolve(call.handle)(call.arguments.template get<Indices>()...);
+    }
+};
@@ -0,0 +1,176 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Compile time dispatch table of Callbacks, indexed by a dense enum (e.g. an opcode)
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <utility>
+
+#include "callback.hpp"
+
+/**
+ * @brief Maps the values 0 to Count - 1 of an enum to Callbacks, built at compile time
+ *
+ * Usage:
+ *   using Handlers = CallbackTable<Opcode, 3, void, const Packet &>;
+ *   constexpr Handlers handlers(
+ *       Handlers::entry(Opcode::Ping, Handlers::CallbackT::bind<&onPing>()),
+ *       Handlers::entry(Opcode::Data, Handlers::CallbackT::bind<&onData>()),
+ *       Handlers::fallback(Handlers::CallbackT::bind<&onUnknown>()));
+ *   handlers.dispatch(packet.opcode, packet);
+ *
+ * Declared constexpr, the table is constant data which can be placed in flash. It replaces a switch
+ * over the opcodes: dispatch() is a bounds check and an indexed call, values without an entry and
+ * out of range values go to the fallback (an empty Callback by default).
+ *
+ * NOTE: Only Callbacks which can be constructed at compile time can be used in a constexpr table
+ * (Functions and Methods bound with bind<>() and empty ones). Keys out of range and keys (or
+ * fallbacks) given twice make a constexpr table fail to build, with a call to _keyOutOfRange() or
+ * _duplicateKey() in the error. A table built at runtime ignores those entries (the first Entry
+ * of a key is taken).
+ *
+ * @tparam Enum The key type, an enum (class) or an integer
+ * @tparam Count Amount of keys, the values of Enum used have to be less than it
+ * @tparam R Return type
+ * @tparam ArgTs Optional Arguments
+ */
+template <typename Enum, std::size_t Count, typename R, typename... ArgTs>
+class CallbackTable {
+   public:
+    using CallbackT = Callback<R, ArgTs...>;
+    using Return = typename CallbackT::Return;
+
+    /**
+     * @brief A key with its Callback, see entry() and fallback()
+     *
+     */
+    struct Entry {
+        std::size_t index;
+        CallbackT callback;
+    };
+
+    /**
+     * @brief Create the Entry of a key
+     *
+     * @param key Has to be less than Count
+     * @param callback
+     * @return constexpr Entry
+     */
+    static constexpr Entry entry(const Enum key, const CallbackT &callback) {
+        return (std::size_t)key < Count ? Entry{(std::size_t)key, callback}
+                                        : _keyOutOfRange(callback);
+    }
+
+    /**
+     * @brief Create the Entry called for keys without an entry and out of range keys
+     *
+     * @param callback
+     * @return constexpr Entry
+     */
+    static constexpr Entry fallback(const CallbackT &callback) { return Entry{Count, callback}; }
+
+    /**
+     * @brief Build the table, each key and the fallback may be given once
+     *
+     * @tparam Entries
+     * @param entries
+     */
+    template <typename... Entries>
+    constexpr CallbackTable(const Entries &...entries)
+        : CallbackTable(Build(), std::make_index_sequence<Count + 1>(), entries...) {}
+
+    /**
+     * @brief Call the Callback of a key, O(1). The values are forwarded, so a by-value Argument
+     * is only constructed once, see CallbackForwardType.
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param key
+     * @param values
+     * @return Return
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline Return dispatch(const Enum key, Us &&...values) const {
+        const std::size_t index = (std::size_t)key;
+        return _callbacks[index < Count ? index : Count].call(std::forward<Us>(values)...);
+    }
+
+    /**
+     * @brief Shorthand for dispatch()
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param key
+     * @param values
+     * @return Return
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline Return operator()(const Enum key, Us &&...values) const {
+        return dispatch(key, std::forward<Us>(values)...);
+    }
+
+    /**
+     * @brief Get the Callback of a key, the fallback if it has none
+     *
+     * @param key
+     * @return constexpr const CallbackT&
+     */
+    constexpr const CallbackT &operator[](const Enum key) const {
+        return _callbacks[(std::size_t)key < Count ? (std::size_t)key : Count];
+    }
+
+    /**
+     * @brief Check if a key has an own entry
+     *
+     * @param key
+     * @return true
+     * @return false
+     */
+    constexpr bool contains(const Enum key) const {
+        return (std::size_t)key < Count && _assigned[(std::size_t)key];
+    }
+
+    static constexpr std::size_t size() { return Count; }
+
+   private:
+    struct Build {};
+
+    // Callbacks of all keys, followed by the fallback
+    const CallbackT _callbacks[Count + 1];
+    const bool _assigned[Count + 1];
+
+    template <std::size_t... Indices, typename... Entries>
+    constexpr CallbackTable(Build, std::index_sequence<Indices...>, const Entries &...entries)
+        : _callbacks{(_contains(Indices, entries...) ? _find(Indices, entries...)
+                                                     : _find(Count, entries...))...},
+          _assigned{_contains(Indices, entries...)...} {}
+
+    static constexpr bool _contains(const std::size_t) { return false; }
+
+    template <typename... Entries>
+    static constexpr bool _contains(const std::size_t index, const Entry &first,
+                                    const Entries &...entries) {
+        return first.index == index || _contains(index, entries...);
+    }
+
+    static constexpr CallbackT _find(const std::size_t) { return CallbackT(); }
+
+    template <typename... Entries>
+    static constexpr CallbackT _find(const std::size_t index, const Entry &first,
+                                     const Entries &...entries) {
+        return first.index == index
+                   ? (_contains(index, entries...) ? _duplicateKey(first.callback)
+                                                   : first.callback)
+                   : _find(index, entries...);
+    }
+
+    // Not constexpr, so calling them fails the build of a constexpr table
+
+    static Entry _keyOutOfRange(const CallbackT &callback) { return Entry{Count + 1, callback}; }
+
+    static CallbackT _duplicateKey(const CallbackT &callback) { return callback; }
+};
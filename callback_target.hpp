@@ -0,0 +1,383 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Lifetime tracked Callbacks, which do nothing anymore once their Object was destroyed
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+#include "callback.hpp"
+
+// Maximum amount of CallbackTargets alive at the same time
+#ifndef CONFIG_CALLBACK_TARGET_SLOTS
+#ifdef PC_BUILD
+#define CONFIG_CALLBACK_TARGET_SLOTS 1024
+#else
+#define CONFIG_CALLBACK_TARGET_SLOTS 32
+#endif
+#endif
+
+class CallbackTarget;
+
+/**
+ * @brief Global table of the slots of all CallbackTargets. A slot outlives its target, so a
+ * Callback can still check it after the target was destroyed. Its generation is increased on every
+ * destruction, free slots are kept in a lock-free stack.
+ *
+ * @tparam Slots Amount of slots, less than 0xFFFF
+ */
+template <std::size_t Slots = CONFIG_CALLBACK_TARGET_SLOTS>
+class CallbackTargetTable {
+    static_assert(Slots > 0 && Slots < 0xFFFF, "Slots have to fit into 16 bit!");
+
+   public:
+    // Index of no slot
+    static constexpr uint16_t none = 0xFFFF;
+
+    struct Slot {
+        std::atomic<uint32_t> generation;
+        std::atomic<uint16_t> next;
+        std::atomic<CallbackTarget *> target;
+    };
+
+    static Slot slots[Slots];
+
+    /**
+     * @brief Take a free slot for target
+     *
+     * @param target
+     * @return uint16_t Index of the slot, none if all slots are in use
+     */
+    static uint16_t acquire(CallbackTarget *const target) {
+        uint32_t head = _free.load(std::memory_order_acquire);
+        uint16_t index;
+
+        while (true) {
+            index = (uint16_t)head;
+
+            if (index == none) {
+                // No released slot, take one which was never used
+                if (_unused.load(std::memory_order_relaxed) >= Slots) {
+                    return none;
+                }
+
+                const uint32_t unused = _unused.fetch_add(1, std::memory_order_relaxed);
+                if (unused >= Slots) {
+                    return none;
+                }
+
+                index = (uint16_t)unused;
+                break;
+            }
+
+            // The tag in the upper half changes on every pop, so an index popped and pushed
+            // again in between can not be mistaken for the old head
+            const uint32_t next = ((head >> 16) + 1) << 16 |
+                                  slots[index].next.load(std::memory_order_relaxed);
+
+            if (_free.compare_exchange_weak(head, next, std::memory_order_acquire)) {
+                break;
+            }
+        }
+
+        slots[index].target.store(target, std::memory_order_relaxed);
+        return index;
+    }
+
+    /**
+     * @brief Give back a slot, all handles of it are dead afterwards
+     *
+     * @param index
+     */
+    static void release(const uint16_t index) {
+        Slot &slot = slots[index];
+        slot.target.store(nullptr, std::memory_order_relaxed);
+        slot.generation.fetch_add(1, std::memory_order_release);
+
+        uint32_t head = _free.load(std::memory_order_relaxed);
+
+        do {
+            slot.next.store((uint16_t)head, std::memory_order_relaxed);
+        } while (!_free.compare_exchange_weak(head, ((head >> 16) + 1) << 16 | index,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+    }
+
+   private:
+    static std::atomic<uint32_t> _free;   // Tag << 16 | index of the first free slot
+    static std::atomic<uint32_t> _unused;
+};
+
+template <std::size_t Slots>
+typename CallbackTargetTable<Slots>::Slot CallbackTargetTable<Slots>::slots[Slots];
+
+template <std::size_t Slots>
+std::atomic<uint32_t> CallbackTargetTable<Slots>::_free(CallbackTargetTable<Slots>::none);
+
+template <std::size_t Slots>
+std::atomic<uint32_t> CallbackTargetTable<Slots>::_unused(0);
+
+/**
+ * @brief Bits needed to store the numbers 0 up to value
+ *
+ * @param value
+ * @return constexpr uint32_t
+ */
+constexpr uint32_t callbackBitWidth(const std::size_t value) {
+    return value == 0 ? 0 : 1 + callbackBitWidth(value >> 1);
+}
+
+/**
+ * @brief Identifies a CallbackTarget without pointing to it. Dies when the target is destroyed.
+ *
+ * The slot index and the lower bits of the generation are packed into a single 32 bit word, so a
+ * tracked Callback to a runtime Method still fits the default buffer of 32 bit targets. The
+ * generation wraps after 2^(32 - index bits) destructions of targets in the same slot (2^26 with
+ * 32 slots), a handle held that long may see a new target of its slot as alive.
+ */
+class CallbackTargetHandle {
+   public:
+    constexpr CallbackTargetHandle() : _packed(_indexMask) {}
+    constexpr CallbackTargetHandle(const uint16_t index, const uint32_t generation)
+        : _packed(generation << _indexBits | index) {}
+
+    /**
+     * @brief Check if the target still exists, a single atomic load
+     *
+     * NOTE: Only tells if the target was destroyed before. Destroying it while another thread
+     * calls it still needs synchronization between the two.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool isAlive() const {
+        return _index() != _indexMask &&
+               CallbackTargetTable<>::slots[_index()].generation.load(std::memory_order_acquire)
+                           << _indexBits ==
+                   (_packed & ~_indexMask);
+    }
+
+    /**
+     * @brief Get the target, only valid while isAlive()
+     *
+     * @return CallbackTarget*
+     */
+    inline CallbackTarget *target() const {
+        return CallbackTargetTable<>::slots[_index()].target.load(std::memory_order_relaxed);
+    }
+
+   private:
+    // The all ones index is kept free for an empty handle
+    static constexpr uint32_t _indexBits = callbackBitWidth(CONFIG_CALLBACK_TARGET_SLOTS);
+    static constexpr uint32_t _indexMask = ((uint32_t)1 << _indexBits) - 1;
+
+    uint32_t _packed;   // Generation << _indexBits | index
+
+    inline uint32_t _index() const { return _packed & _indexMask; }
+};
+
+/**
+ * @brief Intrusive base of Objects which can be the target of tracked Callbacks (see
+ * trackedCallback()). Takes one slot of the CallbackTargetTable while it exists.
+ *
+ * A copy is another target, with its own slot. If all slots are in use, the target is not
+ * tracked (see isTracked()) and trackedCallback() returns an empty Callback to it.
+ *
+ * NOTE: The target is found again with a static_cast from CallbackTarget, so it can not be a
+ * virtual base (inherit from it non-virtually, e.g. only in the most derived class).
+ */
+class CallbackTarget {
+   public:
+    /**
+     * @brief Get a handle to this target, which dies as soon as it is destroyed
+     *
+     * @return CallbackTargetHandle
+     */
+    inline CallbackTargetHandle callbackHandle() const {
+        if (_slot == CallbackTargetTable<>::none) {
+            return CallbackTargetHandle();
+        }
+
+        return CallbackTargetHandle(
+            _slot,
+            CallbackTargetTable<>::slots[_slot].generation.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Check if the target got a slot, otherwise its handle is never alive
+     *
+     * @return true
+     * @return false All slots were in use when it was constructed
+     */
+    inline bool isTracked() const { return _slot != CallbackTargetTable<>::none; }
+
+   protected:
+    CallbackTarget() : _slot(CallbackTargetTable<>::acquire(this)) {}
+    CallbackTarget(const CallbackTarget &) : _slot(CallbackTargetTable<>::acquire(this)) {}
+    CallbackTarget &operator=(const CallbackTarget &) { return *this; }
+
+    ~CallbackTarget() {
+        if (_slot != CallbackTargetTable<>::none) {
+            CallbackTargetTable<>::release(_slot);
+        }
+    }
+
+   private:
+    const uint16_t _slot;
+};
+
+/**
+ * @brief Functor calling a Method of a CallbackTarget only while it is alive, otherwise nothing
+ * is done and a default constructed result is returned. So Methods returning a reference can not
+ * be tracked.
+ *
+ * @tparam T Type of the target, including its const / volatile qualifiers
+ * @tparam M Method (-pointer) type
+ */
+template <typename T, typename M>
+class CallbackTrackedMethod {
+   public:
+    CallbackTrackedMethod(T *const obj, const M method)
+        : _method(method), _handle(obj->callbackHandle()) {}
+
+    template <typename... ArgTs>
+    auto operator()(ArgTs &&...args) const
+        noexcept(CallbackIsMethodInvocable<T, M, void, ArgTs...>::nothrow)
+            -> decltype((std::declval<T &>().*std::declval<M>())(std::forward<ArgTs>(args)...)) {
+        using Result = decltype((std::declval<T &>().*std::declval<M>())(
+            std::forward<ArgTs>(args)...));
+        static_assert(!std::is_reference<Result>::value,
+                      "Tracked Methods can not return a reference, there is nothing to refer to "
+                      "once the Object is destroyed!");
+
+        if (!_handle.isAlive()) {
+            return Result();
+        }
+
+        return (*static_cast<T *>(_handle.target()).*_method)(std::forward<ArgTs>(args)...);
+    }
+
+   private:
+    const M _method;
+    const CallbackTargetHandle _handle;
+};
+
+/**
+ * @brief Same as CallbackTrackedMethod for a Method known at compile time, only the handle is
+ * stored
+ *
+ * @tparam T Type of the target, including its const / volatile qualifiers
+ * @tparam M Method (-pointer) type
+ * @tparam Method
+ */
+template <typename T, typename M, M Method>
+class CallbackTrackedStaticMethod {
+   public:
+    CallbackTrackedStaticMethod(T *const obj) : _handle(obj->callbackHandle()) {}
+
+    template <typename... ArgTs>
+    auto operator()(ArgTs &&...args) const
+        noexcept(CallbackIsMethodInvocable<T, M, void, ArgTs...>::nothrow)
+            -> decltype((std::declval<T &>().*Method)(std::forward<ArgTs>(args)...)) {
+        using Result = decltype((std::declval<T &>().*Method)(std::forward<ArgTs>(args)...));
+        static_assert(!std::is_reference<Result>::value,
+                      "Tracked Methods can not return a reference, there is nothing to refer to "
+                      "once the Object is destroyed!");
+
+        if (!_handle.isAlive()) {
+            return Result();
+        }
+
+        return (*static_cast<T *>(_handle.target()).*Method)(std::forward<ArgTs>(args)...);
+    }
+
+   private:
+    const CallbackTargetHandle _handle;
+};
+
+/**
+ * @brief Tracked Callback for an Object's function, the Object has to derive from CallbackTarget
+ * (not virtually). Once the Object is destroyed, calling the Callback does nothing and returns a
+ * default constructed result, so the Method can not return a reference. If the Object is not
+ * tracked (see CallbackTarget::isTracked()), an empty Callback is returned.
+ *
+ * @tparam T
+ * @tparam M Method (-pointer) type, may be const / volatile / & qualified and noexcept
+ * @param obj
+ * @param method
+ * @return Callback<R>
+ */
+template <typename T, typename M>
+typename CallbackMethodTraits<M>::Type trackedCallback(T *obj, M method) {
+    static_assert(std::is_base_of<CallbackTarget, typename std::remove_cv<T>::type>::value,
+                  "Object has to derive from CallbackTarget!");
+
+    if (obj == nullptr || method == nullptr || !obj->isTracked()) {
+        return typename CallbackMethodTraits<M>::Type();
+    }
+
+    return typename CallbackMethodTraits<M>::Type(CallbackTrackedMethod<T, M>(obj, method));
+}
+
+/**
+ * @brief Tracked Callback for an Object's function
+ *
+ * @tparam T
+ * @tparam M Method (-pointer) type, may be const / volatile / & qualified and noexcept
+ * @param obj
+ * @param method
+ * @return Callback<R>
+ */
+template <typename T, typename M>
+typename CallbackMethodTraits<M>::Type trackedCallback(T &obj, M method) {
+    return trackedCallback(&obj, method);
+}
+
+/**
+ * @brief Tracked Callback for an Object's function known at compile time, only needs the space of
+ * the handle in the buffer. Empty if the Object is not tracked.
+ *
+ * Usage: trackedCallback<decltype(&Driver::onIrq), &Driver::onIrq>(&driver)
+ *
+ * @tparam M Method (-pointer) type
+ * @tparam Method
+ * @tparam T
+ * @param obj
+ * @return Callback<R>
+ */
+template <typename M, M Method, typename T>
+typename CallbackMethodTraits<M>::Type trackedCallback(T *obj) {
+    static_assert(std::is_base_of<CallbackTarget, typename std::remove_cv<T>::type>::value,
+                  "Object has to derive from CallbackTarget!");
+
+    if (obj == nullptr || Method == nullptr || !obj->isTracked()) {
+        return typename CallbackMethodTraits<M>::Type();
+    }
+
+    return typename CallbackMethodTraits<M>::Type(CallbackTrackedStaticMethod<T, M, Method>(obj));
+}
+
+#ifdef __cpp_nontype_template_parameter_auto
+/**
+ * @brief Shorthand for trackedCallback<decltype(Method), Method>(obj) (C++17)
+ *
+ * Usage: trackedCallback<&Driver::onIrq>(&driver)
+ *
+ * @tparam Method
+ * @tparam T
+ * @param obj
+ * @return Callback<R>
+ */
+template <auto Method, typename T>
+typename CallbackMethodTraits<decltype(Method)>::Type trackedCallback(T *obj) {
+    return trackedCallback<decltype(Method), Method>(obj);
+}
+#endif
@@ -0,0 +1,307 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Hierarchical timer wheel of Callbacks, for huge amounts of timeouts without dynamic memory
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "callback.hpp"
+
+/**
+ * @brief Identifies a scheduled timer, to cancel it. Stays invalid after the timer expired or was
+ * canceled, even if its slot is reused.
+ *
+ */
+struct CallbackTimerHandle {
+    uint32_t index = 0xFFFFFFFF;
+    uint32_t generation = 0;
+};
+
+/**
+ * @brief Hierarchical timer wheel calling Callbacks after a delay in ticks
+ *
+ * All timers live in one preallocated array and are linked (by index) into the buckets of the
+ * wheel levels. Scheduling and canceling are O(1), advance() calls all Callbacks of a tick as a
+ * batch. A timer is placed on the lowest level on which its expiry tick and the current tick only
+ * differ within the bits of that level, so it is moved down a level at most Levels - 1 times and
+ * never expires early.
+ *
+ * NOTE: Not thread safe, schedule(), cancel() and advance() have to be called from the same
+ * context. The Callbacks may schedule and cancel timers themselves.
+ *
+ * @tparam Capacity Maximum amount of scheduled timers
+ * @tparam LevelBits log2 of the amount of buckets per level
+ * @tparam Levels Amount of levels, the maximum delay is 2^(LevelBits * Levels) - 1 ticks
+ * @tparam CallbackT The type of the Callbacks, called without Arguments
+ */
+template <std::size_t Capacity, std::size_t LevelBits = 8, std::size_t Levels = 4,
+          typename CallbackT = Callback<void>>
+class CallbackTimerWheel {
+    static_assert(Capacity > 0 && Capacity < 0xFFFFFFFF, "Capacity has to fit into 32 bit!");
+    static_assert(LevelBits > 0 && Levels > 0 && LevelBits * Levels < 64,
+                  "The wheel has to fit into the 64 bit tick counter!");
+    static_assert(Levels << LevelBits < 0xFFFF, "Too many buckets!");
+
+   public:
+    /**
+     * @brief Maximum delay in ticks, longer delays are shortened to it
+     *
+     */
+    static constexpr uint64_t maxDelay = ((uint64_t)1 << (LevelBits * Levels)) - 1;
+
+    /**
+     * @brief Creates an empty wheel
+     *
+     * @param now The current tick
+     */
+    CallbackTimerWheel(const uint64_t now = 0) : _now(now), _free(0), _count(0) {
+        for (std::size_t i = 0; i < Levels * _buckets; i++) {
+            _heads[i] = _none;
+        }
+
+        for (uint32_t i = 0; i < Capacity; i++) {
+            _entries[i].next = i + 1 < Capacity ? i + 1 : _none;
+            _entries[i].bucket = _unused;
+        }
+    }
+
+    CallbackTimerWheel(const CallbackTimerWheel &) = delete;
+    CallbackTimerWheel &operator=(const CallbackTimerWheel &) = delete;
+
+    /**
+     * @brief Call a Callback after delay ticks
+     *
+     * @param callback
+     * @param delay Ticks from now, at least 1 (the Callback is called by the next advance())
+     * @return CallbackTimerHandle To cancel the timer, invalid if the wheel is full
+     */
+    CallbackTimerHandle schedule(const CallbackT &callback, uint64_t delay) {
+        CallbackTimerHandle handle;
+
+        if (_free == _none) {
+            return handle;
+        }
+
+        delay = delay < 1 ? 1 : delay > maxDelay ? maxDelay : delay;
+
+        const uint32_t index = _free;
+        Entry &entry = _entries[index];
+        _free = entry.next;
+
+        entry.callback = callback;
+        entry.expiry = _now + delay;
+        _insert(index);
+        _count++;
+
+        handle.index = index;
+        handle.generation = entry.generation;
+        return handle;
+    }
+
+    /**
+     * @brief Cancel a timer, O(1)
+     *
+     * @param handle
+     * @return true The timer was canceled
+     * @return false The timer already expired or was canceled
+     */
+    bool cancel(const CallbackTimerHandle handle) {
+        if (!isScheduled(handle)) {
+            return false;
+        }
+
+        _unlink(handle.index);
+        _release(handle.index);
+        return true;
+    }
+
+#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
+    /**
+     * @brief Cancel the first timer pointing to the same destination (see pointToSame()). Sweeps
+     * over all slots, prefer cancel(handle) where the handle is known.
+     *
+     * @param callback
+     * @return true A timer was canceled
+     * @return false No timer pointing to the same destination
+     */
+    bool cancel(const CallbackT &callback) {
+        for (uint32_t i = 0; i < Capacity; i++) {
+            if (_entries[i].bucket != _unused && _entries[i].callback.pointToSame(callback)) {
+                _unlink(i);
+                _release(i);
+                return true;
+            }
+        }
+
+        return false;
+    }
+#endif
+
+    /**
+     * @brief Check if a timer is still waiting to expire
+     *
+     * @param handle
+     * @return true
+     * @return false
+     */
+    inline bool isScheduled(const CallbackTimerHandle handle) const {
+        return handle.index < Capacity && _entries[handle.index].bucket != _unused &&
+               _entries[handle.index].generation == handle.generation;
+    }
+
+    /**
+     * @brief Advance the time and call the Callbacks of all expired timers, tick by tick
+     *
+     * @param ticks
+     * @return std::size_t Amount of called Callbacks
+     */
+    std::size_t advance(uint64_t ticks = 1) {
+        std::size_t called = 0;
+
+        for (; ticks > 0; ticks--) {
+            if (_count == 0) {
+                _now += ticks;
+                break;
+            }
+
+            _now++;
+            _cascade();
+
+            // The whole bucket expires now. Every Callback is released before it is called, so
+            // it may reschedule itself or cancel others in the same bucket.
+            uint32_t &head = _heads[_now & (_buckets - 1)];
+
+            while (head != _none) {
+                const uint32_t index = head;
+                const CallbackT callback = _entries[index].callback;
+
+                _unlink(index);
+                _release(index);
+
+                callback();
+                called++;
+            }
+        }
+
+        return called;
+    }
+
+    /**
+     * @brief Get the current tick
+     *
+     * @return uint64_t
+     */
+    inline uint64_t now() const { return _now; }
+
+    /**
+     * @brief Get the amount of scheduled timers
+     *
+     * @return std::size_t
+     */
+    inline std::size_t size() const { return _count; }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+   private:
+    static constexpr uint32_t _none = 0xFFFFFFFF;
+    static constexpr uint16_t _unused = 0xFFFF;
+    static constexpr std::size_t _buckets = (std::size_t)1 << LevelBits;
+
+    struct Entry {
+        CallbackT callback;
+        uint64_t expiry;
+        uint32_t next;
+        uint32_t prev;
+        uint32_t generation = 0;
+        uint16_t bucket;   // Level * _buckets + bucket of the level, _unused if free
+    };
+
+    Entry _entries[Capacity];
+    uint32_t _heads[Levels * _buckets];
+    uint64_t _now;
+    uint32_t _free;
+    std::size_t _count;
+
+    /**
+     * @brief Link an Entry into the bucket of its expiry on the lowest level where the expiry and
+     * now only differ within this level
+     *
+     * @param index
+     */
+    void _insert(const uint32_t index) {
+        Entry &entry = _entries[index];
+        std::size_t level = 0;
+
+        while (level + 1 < Levels &&
+               (entry.expiry >> (LevelBits * (level + 1))) != (_now >> (LevelBits * (level + 1)))) {
+            level++;
+        }
+
+        entry.bucket =
+            (uint16_t)(level * _buckets + ((entry.expiry >> (LevelBits * level)) & (_buckets - 1)));
+        entry.prev = _none;
+        entry.next = _heads[entry.bucket];
+
+        if (entry.next != _none) {
+            _entries[entry.next].prev = index;
+        }
+
+        _heads[entry.bucket] = index;
+    }
+
+    void _unlink(const uint32_t index) {
+        Entry &entry = _entries[index];
+
+        if (entry.prev != _none) {
+            _entries[entry.prev].next = entry.next;
+        } else {
+            _heads[entry.bucket] = entry.next;
+        }
+
+        if (entry.next != _none) {
+            _entries[entry.next].prev = entry.prev;
+        }
+    }
+
+    void _release(const uint32_t index) {
+        Entry &entry = _entries[index];
+        entry.bucket = _unused;
+        entry.generation++;
+        entry.next = _free;
+
+        _free = index;
+        _count--;
+    }
+
+    /**
+     * @brief Once the lower levels wrapped around, move the timers of the now current bucket of a
+     * higher level down. Done from the top, so timers moved into the current bucket of the level
+     * below are moved down further in the same tick.
+     *
+     */
+    void _cascade() {
+        std::size_t level = 1;
+
+        while (level < Levels && (_now & (((uint64_t)1 << (LevelBits * level)) - 1)) == 0) {
+            level++;
+        }
+
+        for (; level > 1; level--) {
+            const std::size_t bucket =
+                (level - 1) * _buckets + ((_now >> (LevelBits * (level - 1))) & (_buckets - 1));
+            uint32_t index = _heads[bucket];
+            _heads[bucket] = _none;
+
+            while (index != _none) {
+                const uint32_t next = _entries[index].next;
+                _insert(index);
+                index = next;
+            }
+        }
+    }
+};
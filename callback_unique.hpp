@@ -0,0 +1,216 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Move-only Callbacks owning their Functor, e.g. a Lambda holding a std::unique_ptr
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "callback.hpp"
+
+/**
+ * @brief A Callback which owns its Functor and can only be moved (like std::move_only_function)
+ *
+ * The Functor is stored in the internal buffer like in Callback, but it only has to be nothrow
+ * move constructible (e.g. a Lambda capturing a std::unique_ptr or a handle). It is destroyed with
+ * the UniqueCallback. No dynamic memory is used. As the Functor is owned, it is called non-const,
+ * so mutable Lambdas work as well.
+ *
+ * @tparam BufferSize Size of the internal buffer holding the Functor
+ * @tparam R Return type
+ * @tparam ArgTs Optional Arguments
+ */
+template <std::size_t BufferSize, typename R, typename... ArgTs>
+class InplaceUniqueCallback {
+    static_assert(BufferSize >= sizeof(void *), "Internal Buffer has to at least hold a pointer!");
+
+   public:
+    using Return = R;
+    using Function = R (*)(ArgTs...);
+
+    /**
+     * @brief Creates an empty callback with no destination
+     *
+     */
+    InplaceUniqueCallback() : _invoker(nullptr), _relocate(nullptr), _storage() {}
+
+    InplaceUniqueCallback(std::nullptr_t) : InplaceUniqueCallback() {}
+
+    /**
+     * @brief Construct a UniqueCallback to a Function
+     *
+     * @param func
+     */
+    InplaceUniqueCallback(const Function func) : InplaceUniqueCallback() {
+        if (func != nullptr) {
+            new (_storage) Function(func);
+            _invoker = &FunctorCaller<Function>::invoke;
+        }
+    }
+
+    /**
+     * @brief Construct a UniqueCallback taking over a Functor (e.g. a Lambda)
+     *
+     * @tparam F
+     * @param functor
+     */
+    template <typename F, typename D = typename std::decay<F>::type,
+              typename = typename std::enable_if<
+                  std::is_class<D>::value && !std::is_same<D, InplaceUniqueCallback>::value &&
+                  (std::is_void<R>::value ||
+                   std::is_convertible<decltype(std::declval<D &>()(std::declval<ArgTs>()...)),
+                                       R>::value)>::type>
+    InplaceUniqueCallback(F &&functor) : InplaceUniqueCallback() {
+        static_assert(sizeof(D) <= BufferSize, "Internal Buffer is too small!");
+        static_assert(alignof(D) <= alignof(void *), "Functor alignment is too big!");
+        static_assert(std::is_nothrow_move_constructible<D>::value,
+                      "Functor has to be nothrow move constructible!");
+
+        new (_storage) D(std::forward<F>(functor));
+        _invoker = &FunctorCaller<D>::invoke;
+        _relocate = _isTrivial<D>() ? nullptr : &FunctorCaller<D>::relocate;
+    }
+
+    InplaceUniqueCallback(InplaceUniqueCallback &&other) noexcept : InplaceUniqueCallback() {
+        _take(other);
+    }
+
+    InplaceUniqueCallback(const InplaceUniqueCallback &) = delete;
+    InplaceUniqueCallback &operator=(const InplaceUniqueCallback &) = delete;
+
+    InplaceUniqueCallback &operator=(InplaceUniqueCallback &&other) noexcept {
+        if (this != &other) {
+            reset();
+            _take(other);
+        }
+
+        return *this;
+    }
+
+    ~InplaceUniqueCallback() { reset(); }
+
+    /**
+     * @brief Destroy the Functor, the UniqueCallback is empty afterwards
+     *
+     */
+    void reset() {
+        if (_relocate != nullptr) {
+            _relocate(nullptr, _storage);
+        }
+
+        _invoker = nullptr;
+        _relocate = nullptr;
+    }
+
+    /**
+     * @brief Call the Callback, an empty one returns R(0). The values are forwarded, so a by-value
+     * Argument is only constructed once, see CallbackForwardType.
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param values
+     * @return R
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline R call(Us &&...values) { return _call<R>(std::forward<Us>(values)...); }
+
+    /**
+     * @brief Shorthand for call()
+     *
+     * @tparam Us Have to be convertible to ArgTs
+     * @param values
+     * @return R
+     */
+    template <typename... Us, typename = CallbackEnableIfConvertible<CallbackTypes<Us...>,
+                                                                     CallbackTypes<ArgTs...>>>
+    inline R operator()(Us &&...values) { return _call<R>(std::forward<Us>(values)...); }
+
+    inline bool isCallbackSet() const { return _invoker != nullptr; }
+
+    inline explicit operator bool() const { return isCallbackSet(); }
+
+   private:
+    using Invoker = R (*)(void *caller, CallbackForwardType<ArgTs>... args);
+
+    /**
+     * @brief Move constructs the Functor at source into target and destroys it at source, only
+     * destroys it if target is nullptr
+     *
+     */
+    using Relocate = void (*)(void *target, void *source);
+
+    template <typename F>
+    class FunctorCaller {
+       public:
+        static R invoke(void *caller, CallbackForwardType<ArgTs>... args) {
+            return static_cast<R>((*(F *)caller)(callbackForward<ArgTs>(args)...));
+        }
+
+        static void relocate(void *const target, void *const source) {
+            if (target != nullptr) {
+                new (target) F(std::move(*(F *)source));
+            }
+
+            ((F *)source)->~F();
+        }
+    };
+
+    Invoker _invoker;
+    Relocate _relocate;   // nullptr if the Functor can be moved with memcpy and needs no destructor
+    // Zeroed on construction, so moving a smaller Functor never copies uninitialized bytes
+    alignas(void *) uint8_t _storage[BufferSize];
+
+    template <typename F>
+    static constexpr bool _isTrivial() {
+        return std::is_trivially_copyable<F>::value && std::is_trivially_destructible<F>::value;
+    }
+
+    void _take(InplaceUniqueCallback &other) {
+        if (other._relocate != nullptr) {
+            other._relocate(_storage, other._storage);
+        } else {
+            memcpy(_storage, other._storage, BufferSize);
+        }
+
+        _invoker = other._invoker;
+        _relocate = other._relocate;
+        other._invoker = nullptr;
+        other._relocate = nullptr;
+    }
+
+    template <typename RN>
+    inline typename std::enable_if<!std::is_same<RN, void>::value, RN>::type _call(
+        CallbackForwardType<ArgTs>... args) {
+        if (_invoker != nullptr) {
+            return _invoker(_storage, callbackForward<ArgTs>(args)...);
+        }
+
+        return (RN)0;
+    }
+
+    template <typename RN>
+    inline typename std::enable_if<std::is_same<RN, void>::value, RN>::type _call(
+        CallbackForwardType<ArgTs>... args) {
+        if (_invoker != nullptr) {
+            _invoker(_storage, callbackForward<ArgTs>(args)...);
+        }
+    }
+};
+
+/**
+ * @brief UniqueCallback with the default buffer size of Callback (CALLBACK_INTERNAL_BUFFER_SIZE)
+ *
+ * @tparam R Return type
+ * @tparam ArgTs Optional Arguments
+ */
+template <typename R, typename... ArgTs>
+using UniqueCallback = InplaceUniqueCallback<CALLBACK_INTERNAL_BUFFER_SIZE, R, ArgTs...>;
@@ -0,0 +1,63 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Minimal header-only test harness, every test file is its own executable registered with
+ * CTest
+ *
+ * A failed CHECK() prints the expression and continues, testResult() is returned from main() so
+ * the executable fails if any CHECK() failed.
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+inline uint32_t &testFailures() {
+    static uint32_t failures = 0;
+    return failures;
+}
+
+/**
+ * @brief Record the result of a check, prints it if it failed
+ *
+ * @param ok
+ * @param expression
+ * @param file
+ * @param line
+ * @return true
+ * @return false
+ */
+inline bool testCheck(const bool ok, const char *const expression, const char *const file,
+                      const int line) {
+    if (!ok) {
+        printf("%s:%d: CHECK(%s) failed\n", file, line, expression);
+        testFailures()++;
+    }
+    return ok;
+}
+
+#define CHECK(expression) testCheck((expression), #expression, __FILE__, __LINE__)
+
+/**
+ * @brief Print the name of the next test
+ *
+ * @param name
+ */
+inline void testCase(const char *const name) { printf("-- %s\n", name); }
+
+/**
+ * @brief Exit code of the test executable
+ *
+ * @return int 0 if no CHECK() failed
+ */
+inline int testResult() {
+    if (testFailures() != 0) {
+        printf("FAILED: %u checks\n", (unsigned int)testFailures());
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Checks that every callable type of this library constructs a by-value Argument at most
+ * once per call
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include <utility>
+
+#include "callback.hpp"
+#include "callback_atomic.hpp"
+#include "callback_batch.hpp"
+#include "callback_list.hpp"
+#include "callback_pool.hpp"
+#include "callback_ref.hpp"
+#include "callback_registry.hpp"
+#include "callback_table.hpp"
+#include "callback_unique.hpp"
+#include "test.hpp"
+
+// Counts its copies and moves
+struct Frame {
+    static uint32_t constructions;
+
+    uint8_t data[200];
+
+    Frame() : data() {}
+    Frame(const Frame &other) {
+        *this = other;
+        constructions++;
+    }
+
+    Frame(Frame &&other) {
+        *this = other;
+        constructions++;
+    }
+
+    Frame &operator=(const Frame &) = default;
+};
+
+uint32_t Frame::constructions = 0;
+
+enum class FrameKey { consume, count };
+
+using FrameTable = CallbackTable<FrameKey, (std::size_t)FrameKey::count, uint32_t, Frame>;
+
+static uint32_t consumed = 0;
+
+static uint32_t consumeFrame(Frame frame) { return consumed += frame.data[0] + 1; }
+
+struct FrameConsumer {
+    void consume(Frame frame) { consumed += frame.data[0] + 1; }
+};
+
+/**
+ * @brief Check that a callable type constructs a by-value Frame at most once per call, for an
+ * lvalue and for an rvalue
+ *
+ * @tparam C
+ * @param name
+ * @param callable Calls consumeFrame() with its Argument
+ */
+template <typename C>
+static void checkFrameCopies(const char *name, C &callable) {
+    testCase(name);
+
+    Frame frame;
+
+    Frame::constructions = 0;
+    consumed = 0;
+    callable(frame);
+    CHECK(Frame::constructions <= 1);
+    CHECK(consumed == 1);
+
+    Frame::constructions = 0;
+    consumed = 0;
+    callable(Frame());
+    CHECK(Frame::constructions <= 1);
+    CHECK(consumed == 1);
+}
+
+int main() {
+    Callback<uint32_t, Frame> callback(&consumeFrame);
+    UniqueCallback<uint32_t, Frame> unique(&consumeFrame);
+    CallbackRef<uint32_t, Frame> ref(&consumeFrame);
+    AtomicCallbackSlot<uint32_t, Frame> slot(callback);
+    PooledCallback<uint32_t, Frame> pooled(&consumeFrame);
+    CallbackRegistry<1, uint32_t, Frame> registry;
+    const CallbackHandle handle = registry.add(callback);
+    auto dispatch = [&registry, handle](auto &&frame) {
+        return registry.dispatch(handle, std::forward<decltype(frame)>(frame));
+    };
+    auto dispatchOperator = [&registry, handle](auto &&frame) {
+        return registry(handle, std::forward<decltype(frame)>(frame));
+    };
+    CallbackList<1, uint32_t, Frame> list;
+    list.add(callback);
+    const FrameTable table(FrameTable::entry(FrameKey::consume, callback));
+    auto tableDispatch = [&table](auto &&frame) {
+        return table.dispatch(FrameKey::consume, std::forward<decltype(frame)>(frame));
+    };
+    auto tableOperator = [&table](auto &&frame) {
+        return table(FrameKey::consume, std::forward<decltype(frame)>(frame));
+    };
+    FrameConsumer consumer;
+    CallbackBatch<FrameConsumer, 1, 1, Frame> batch;
+    batch.add(&consumer, &FrameConsumer::consume);
+
+    checkFrameCopies("Callback", callback);
+    checkFrameCopies("UniqueCallback", unique);
+    checkFrameCopies("CallbackRef", ref);
+    checkFrameCopies("AtomicCallbackSlot", slot);
+    checkFrameCopies("PooledCallback", pooled);
+    checkFrameCopies("CallbackRegistry::dispatch", dispatch);
+    checkFrameCopies("CallbackRegistry::operator()", dispatchOperator);
+    checkFrameCopies("CallbackList (one Callback)", list);
+    checkFrameCopies("CallbackTable::dispatch", tableDispatch);
+    checkFrameCopies("CallbackTable::operator()", tableOperator);
+    checkFrameCopies("CallbackBatch (one Object)", batch);
+
+    return testResult();
+}
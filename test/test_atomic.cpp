@@ -0,0 +1,98 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests AtomicCallbackSlot: store(), exchange(), load() and loads racing with stores
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include <atomic>
+#include <thread>
+
+#include "callback_atomic.hpp"
+#include "test.hpp"
+
+struct Value {
+    uint32_t value;
+
+    uint32_t get() const { return value; }
+    uint32_t getTimesTen() const { return value * 10; }
+    uint32_t add(uint32_t other) const { return value + other; }
+};
+
+static void testSlot() {
+    testCase("store, exchange and load");
+
+    const Value one{1}, two{2};
+
+    AtomicCallbackSlot<uint32_t> empty;
+    CHECK(!empty.load().isCallbackSet());
+
+    AtomicCallbackSlot<uint32_t, uint32_t> slot(Callback<uint32_t, uint32_t>(&one, &Value::add));
+    CHECK(slot.call(5) == 6);
+    CHECK(slot(5) == 6);
+
+    CHECK(slot.store(Callback<uint32_t, uint32_t>(&two, &Value::add)));
+    CHECK(slot(5) == 7);
+    CHECK(slot.load()(5) == 7);
+
+    Callback<uint32_t, uint32_t> previous;
+    CHECK(slot.exchange(Callback<uint32_t, uint32_t>(&one, &Value::add), previous));
+    CHECK(previous(5) == 7);
+    CHECK(slot(5) == 6);
+
+    // Stores one after another reuse both buffers
+    for (uint32_t i = 0; i < 10; i++) {
+        CHECK(slot.store(Callback<uint32_t, uint32_t>(i % 2 ? &one : &two, &Value::add)));
+        CHECK(slot(0) == (i % 2 ? 1u : 2u));
+    }
+}
+
+/**
+ * @brief Loads while two threads store two Callbacks, which only differ in all words together.
+ * A torn Callback would return 2 or 10.
+ *
+ */
+static void testConcurrent() {
+    testCase("Loads racing with stores");
+
+    static const Value one{1}, two{2};
+    static const Callback<uint32_t> first(&one, &Value::get);
+    static const Callback<uint32_t> second(&two, &Value::getTimesTen);
+
+    AtomicCallbackSlot<uint32_t> slot(first);
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> stores(0);
+
+    auto store = [&slot, &stop, &stores]() {
+        for (uint32_t i = 0; !stop.load(); i++) {
+            if (slot.store(i % 2 ? first : second)) {
+                stores++;
+            }
+        }
+    };
+
+    std::thread storeA(store);
+    std::thread storeB(store);
+
+    bool torn = false;
+    for (uint32_t i = 0; i < 1000000; i++) {
+        const uint32_t value = slot();
+        torn = torn || (value != 1 && value != 20);
+    }
+
+    stop = true;
+    storeA.join();
+    storeB.join();
+
+    CHECK(!torn);
+    CHECK(stores > 0);
+    CHECK(slot() == 1 || slot() == 20);
+}
+
+int main() {
+    testSlot();
+    testConcurrent();
+
+    return testResult();
+}
@@ -0,0 +1,127 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests CallbackBatch: grouping by Method on add() and remove(), the order within a group
+ * and the Arguments passed to every Object
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include "callback_batch.hpp"
+#include "test.hpp"
+
+// Ids of the Objects in the order they were called
+static uint32_t calls[32];
+static uint32_t callCount = 0;
+
+struct Sensor {
+    uint32_t id = 0;
+    int32_t value = 0;
+
+    void update(int32_t delta) {
+        value += delta;
+        calls[callCount++] = id;
+    }
+
+    void reset(int32_t) {
+        value = 0;
+        calls[callCount++] = id + 100;
+    }
+};
+
+using Batch = CallbackBatch<Sensor, 8, 2, int32_t>;
+
+/**
+ * @brief Emit and compare the order of the calls
+ *
+ * @param batch
+ * @param expected Ids in the expected order, reset() calls are offset by 100
+ * @param count
+ * @return true
+ * @return false
+ */
+static bool emitsInOrder(const Batch &batch, const uint32_t *const expected,
+                         const uint32_t count) {
+    callCount = 0;
+    batch.emit(1);
+
+    bool same = callCount == count;
+    for (uint32_t i = 0; same && i < count; i++) {
+        same = calls[i] == expected[i];
+    }
+
+    return same;
+}
+
+static void testGroups() {
+    testCase("Order within a group");
+
+    Sensor sensors[8];
+    for (uint32_t i = 0; i < 8; i++) {
+        sensors[i].id = i;
+    }
+
+    Batch batch;
+    CHECK(batch.add(&sensors[2], &Sensor::update));
+    CHECK(batch.add(&sensors[0], &Sensor::update));
+    CHECK(batch.add(&sensors[1], &Sensor::reset));
+    CHECK(batch.add(&sensors[3], &Sensor::update));
+    CHECK(batch.add(&sensors[4], &Sensor::reset));
+    CHECK(batch.size() == 5);
+    CHECK(batch.groups() == 2);
+
+    // Group by group, in the order their first Object was added
+    const uint32_t added[] = {2, 0, 3, 101, 104};
+    CHECK(emitsInOrder(batch, added, 5));
+    CHECK(sensors[2].value == 1 && sensors[0].value == 1 && sensors[3].value == 1);
+
+    batch(2);
+    CHECK(sensors[3].value == 3);
+
+    testCase("Regrouping on add and remove");
+
+    // Removing from the first group moves the second one
+    CHECK(batch.remove(&sensors[0], &Sensor::update));
+    CHECK(!batch.remove(&sensors[0], &Sensor::update));
+    CHECK(!batch.remove(&sensors[1], &Sensor::update));
+    const uint32_t removed[] = {2, 3, 101, 104};
+    CHECK(emitsInOrder(batch, removed, 4));
+
+    // An Object may be added to several groups and to one group several times
+    CHECK(batch.add(&sensors[1], &Sensor::update));
+    CHECK(batch.add(&sensors[2], &Sensor::update));
+    const uint32_t twice[] = {2, 3, 1, 2, 101, 104};
+    CHECK(emitsInOrder(batch, twice, 6));
+
+    // An emptied group is removed, a new one is appended after the remaining groups
+    CHECK(batch.remove(&sensors[1], &Sensor::reset));
+    CHECK(batch.remove(&sensors[4], &Sensor::reset));
+    CHECK(batch.groups() == 1);
+    CHECK(batch.remove(&sensors[2], &Sensor::update));
+    CHECK(batch.remove(&sensors[3], &Sensor::update));
+    CHECK(batch.add(&sensors[5], &Sensor::reset));
+    const uint32_t regrouped[] = {1, 2, 105};
+    CHECK(emitsInOrder(batch, regrouped, 3));
+
+    testCase("Capacity");
+
+    CHECK(!batch.add(nullptr, &Sensor::update));
+    CHECK(!batch.add(&sensors[0], nullptr));
+
+    for (uint32_t i = 0; i < 5; i++) {
+        CHECK(batch.add(&sensors[i], &Sensor::update));
+    }
+
+    CHECK(batch.size() == Batch::capacity());
+    CHECK(!batch.add(&sensors[7], &Sensor::update));
+
+    batch.clear();
+    CHECK(batch.size() == 0 && batch.groups() == 0);
+    CHECK(emitsInOrder(batch, nullptr, 0));
+}
+
+int main() {
+    testGroups();
+
+    return testResult();
+}
@@ -0,0 +1,317 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests Callback: Functions, Methods of any qualifiers, bind<>(), bindFront(), constexpr
+ * construction, comparison and hashing, relocateCallbacks() and noexcept Callbacks
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include <set>
+#include <unordered_set>
+
+#include "callback.hpp"
+#include "test.hpp"
+
+static int32_t hits = 0;
+
+static void hitNoexcept(int32_t value) noexcept { hits += value; }
+
+static int32_t twice(int32_t value) { return value * 2; }
+
+static int32_t sum(int32_t a, int32_t b, int32_t c) { return a * 100 + b * 10 + c; }
+
+struct Receiver {
+    int32_t value = 0;
+
+    void add(int32_t other) noexcept { value += other; }
+    void addConst(int32_t other) const noexcept { hits += other + value; }
+
+    int32_t get(int32_t offset) { return value + offset; }
+    int32_t getConst(int32_t offset) const { return value + offset + 1; }
+    int32_t getVolatile(int32_t offset) volatile { return value + offset + 2; }
+    int32_t getLvalue(int32_t offset) & { return value + offset + 3; }
+    int32_t getConstLvalue(int32_t offset) const & noexcept { return value + offset + 4; }
+};
+
+using Get = Callback<int32_t, int32_t>;
+using Sum = Callback<int32_t, int32_t, int32_t, int32_t>;
+
+#ifdef CONFIG_CALLBACK_NULL_INVOKER
+struct Point {
+    int32_t x;
+    int32_t y;
+};
+
+static Point origin() { return Point{1, 2}; }
+#endif
+
+static void testConstruct() {
+    testCase("Functions, Functors and empty Callbacks");
+
+    const Get function(&twice);
+    CHECK(function.isCallbackSet());
+    CHECK(function(4) == 8);
+    CHECK(callback(&twice).call(5) == 10);
+
+    const int32_t offset = 3;
+    const Get lambda = [offset](int32_t value) { return value + offset; };
+    CHECK(lambda(4) == 7);
+
+    const Get empty;
+    const Get null(nullptr);
+    CHECK(!empty.isCallbackSet());
+    CHECK(!null.isCallbackSet());
+    CHECK(empty(4) == 0);
+    CHECK(empty == null);
+
+#ifdef CONFIG_CALLBACK_NULL_INVOKER
+    // The shared no-op invoker returns a default constructed value of any type
+    const Callback<Point> point(&origin);
+    CHECK(point().x == 1 && point().y == 2);
+    CHECK(Callback<Point>()().x == 0);
+#endif
+
+    testCase("Methods of any qualifiers");
+
+    Receiver receiver;
+    receiver.value = 10;
+    const Receiver &constReceiver = receiver;
+    volatile Receiver &volatileReceiver = receiver;
+
+    CHECK(Get(&receiver, &Receiver::get)(1) == 11);
+    CHECK(Get(&constReceiver, &Receiver::getConst)(1) == 12);
+    CHECK(Get(&receiver, &Receiver::getConst)(1) == 12);
+    CHECK(Get(&volatileReceiver, &Receiver::getVolatile)(1) == 13);
+    CHECK(Get(&receiver, &Receiver::getLvalue)(1) == 14);
+    CHECK(callback(receiver, &Receiver::getConstLvalue)(1) == 15);
+
+    Receiver *const nullReceiver = nullptr;
+    CHECK(!Get(nullReceiver, &Receiver::get).isCallbackSet());
+
+    // The Object is referenced, not copied
+    receiver.value = 20;
+    CHECK(Get(&receiver, &Receiver::get)(1) == 21);
+}
+
+static void testBind() {
+    testCase("bind<>()");
+
+    Receiver receiver;
+    receiver.value = 10;
+    const Receiver &constReceiver = receiver;
+
+    const Get function = Get::bind<&twice>();
+    CHECK(function(3) == 6);
+    CHECK(function == Get::bind<&twice>());
+    CHECK(function != Get(&twice));
+
+    CHECK((Get::bind<Receiver, &Receiver::get>(&receiver)(1) == 11));
+    CHECK((Get::bind<Receiver, &Receiver::getConst>(&constReceiver)(1) == 12));
+    CHECK(Get::bind<&Receiver::getLvalue>(&receiver)(1) == 14);
+    CHECK(Get::bind<&Receiver::getConstLvalue>(&constReceiver)(1) == 15);
+    CHECK(!Get::bind<&Receiver::get>(static_cast<Receiver *>(nullptr)).isCallbackSet());
+
+    testCase("bindFront()");
+
+    const Sum three(&sum);
+    const auto two = three.bindFront(1);
+    const auto none = three.bindFront(1, 2, 3);
+    CHECK(two(2, 3) == 123);
+    CHECK(none() == 123);
+    CHECK(two.bindFront(4)(5) == 145);
+
+    // A chosen buffer, e.g. to store it in a container of Callbacks of that size
+    const InplaceCallback<64, int32_t, int32_t> one = three.bindFront<64>(7, 8);
+    CHECK(one(9) == 789);
+
+    // The values are copied
+    int32_t value = 4;
+    const auto copied = Get(&twice).bindFront(value);
+    value = 5;
+    CHECK(copied() == 8);
+
+    CHECK(!Sum().bindFront(1).isCallbackSet());
+}
+
+// Placed in read-only memory, no constructor runs
+static constexpr Get constFunction(&twice);
+static constexpr Get constBound = Get::bind<&twice>();
+static constexpr Get constEmpty;
+
+static Receiver staticReceiver;
+static constexpr Get constMethod = Get::bind<Receiver, &Receiver::get>(&staticReceiver);
+
+static void testConstexpr() {
+    testCase("constexpr construction");
+
+    static_assert(std::is_trivially_destructible<Get>::value, "A Callback needs no destructor");
+
+    staticReceiver.value = 1;
+    CHECK(constFunction(2) == 4);
+    CHECK(constBound(3) == 6);
+    CHECK(!constEmpty.isCallbackSet());
+    CHECK(constMethod(1) == 2);
+}
+
+static void testCompare() {
+    testCase("Comparison and hashing");
+
+    Receiver first, second;
+    const Get callbacks[] = {
+        Get(),
+        Get(&twice),
+        Get(&first, &Receiver::get),
+        Get(&second, &Receiver::get),
+        Get(&first, &Receiver::getConst),
+        Get::bind<&twice>(),
+        Get::bind<Receiver, &Receiver::get>(&first),
+    };
+    const std::size_t count = sizeof(callbacks) / sizeof(callbacks[0]);
+
+    // Each one equals only itself and a copy of itself, exactly one of two others points before
+    bool consistent = true;
+    for (std::size_t i = 0; i < count; i++) {
+        const Get copy = callbacks[i];
+        consistent = consistent && copy == callbacks[i] && copy.hash() == callbacks[i].hash() &&
+                     !copy.pointsBefore(callbacks[i]);
+
+        for (std::size_t j = 0; j < count; j++) {
+            if (i != j) {
+                consistent = consistent && callbacks[i] != callbacks[j] &&
+                             callbacks[i].pointsBefore(callbacks[j]) !=
+                                 callbacks[j].pointsBefore(callbacks[i]);
+            }
+        }
+    }
+    CHECK(consistent);
+
+    CHECK(std::hash<Get>()(callbacks[2]) == callbacks[2].hash());
+
+    std::set<Get> sorted(callbacks, callbacks + count);
+    std::unordered_set<Get> hashed(callbacks, callbacks + count);
+    CHECK(sorted.size() == count);
+    CHECK(hashed.size() == count);
+    CHECK(sorted.count(Get(&second, &Receiver::get)) == 1);
+    CHECK(hashed.count(Get(&first, &Receiver::getConst)) == 1);
+    CHECK(hashed.count(Get(&second, &Receiver::getConst)) == 0);
+
+    // Through the interface of Callbacks of unknown type
+#ifndef CONFIG_CALLBACK_NO_COMPARE_BASE
+    const CallbackCompare &base = callbacks[1];
+    CHECK(callbacks[1] == base);
+    CHECK(!(callbacks[2] == base));
+    CHECK(!(Callback<int32_t>() == base));
+#endif
+}
+
+// Not trivially relocatable, counts its moves
+struct Tracked {
+    static int32_t alive;
+
+    int32_t value;
+    Tracked *self;
+
+    explicit Tracked(int32_t value) : value(value), self(this) { alive++; }
+    Tracked(Tracked &&other) : value(other.value), self(this) { alive++; }
+    ~Tracked() { alive--; }
+};
+
+int32_t Tracked::alive = 0;
+
+static void testRelocate() {
+    testCase("relocateCallbacks()");
+
+    static_assert(CallbackIsTriviallyRelocatable<Get>::value, "Callbacks are moved with memmove");
+    static_assert(!CallbackIsTriviallyRelocatable<Tracked>::value,
+                  "Tracked has a move constructor");
+
+    // Overlapping to the front and to the back
+    alignas(Get) uint8_t raw[5 * sizeof(Get)];
+    Get *const callbacks = (Get *)raw;
+    Receiver receiver;
+    receiver.value = 10;
+
+    new (&callbacks[0]) Get(&twice);
+    new (&callbacks[1]) Get(&receiver, &Receiver::get);
+    new (&callbacks[2]) Get([](int32_t value) { return -value; });
+
+    relocateCallbacks(callbacks + 2, callbacks, 3);
+    CHECK(callbacks[2](1) == 2 && callbacks[3](1) == 11 && callbacks[4](1) == -1);
+
+    relocateCallbacks(callbacks, callbacks + 1, 4);
+    CHECK(callbacks[1](1) == 2 && callbacks[2](1) == 11 && callbacks[3](1) == -1);
+
+    alignas(Tracked) uint8_t trackedRaw[4 * sizeof(Tracked)];
+    Tracked *const tracked = (Tracked *)trackedRaw;
+    Tracked::alive = 0;
+
+    new (&tracked[0]) Tracked(1);
+    new (&tracked[1]) Tracked(2);
+    new (&tracked[2]) Tracked(3);
+
+    relocateCallbacks(tracked + 1, tracked, 3);
+    CHECK(tracked[1].value == 1 && tracked[2].value == 2 && tracked[3].value == 3);
+    CHECK(tracked[1].self == &tracked[1] && tracked[3].self == &tracked[3]);
+
+    relocateCallbacks(tracked, tracked + 1, 3);
+    CHECK(tracked[0].value == 1 && tracked[1].value == 2 && tracked[2].value == 3);
+    CHECK(Tracked::alive == 3);
+
+    for (uint32_t i = 0; i < 3; i++) {
+        tracked[i].~Tracked();
+    }
+}
+
+using Plain = Callback<void, int32_t>;
+using Noexcept = InplaceCallback<CALLBACK_INTERNAL_BUFFER_SIZE, void(int32_t) noexcept>;
+
+static void testNoexcept() {
+    testCase("noexcept Callbacks");
+
+    Receiver receiver;
+    const Noexcept function(&hitNoexcept);
+    const Noexcept method(&receiver, &Receiver::add);
+    static_assert(noexcept(function(1)), "A noexcept Callback is called without a landing pad");
+
+    hits = 0;
+    function(2);
+    method(3);
+    CHECK(hits == 2);
+    CHECK(receiver.value == 3);
+
+    testCase("Converted noexcept Callbacks compare equal to direct ones");
+
+    auto lambda = [](int32_t value) noexcept { hits += value; };
+
+    CHECK(Plain(function).pointToSame(Plain(&hitNoexcept)));
+    CHECK(Plain(method) == Plain(&receiver, &Receiver::add));
+    CHECK(Plain(Noexcept(lambda)) == Plain(lambda));
+    CHECK(Plain(Noexcept::bind<&Receiver::addConst>(&receiver)) ==
+          Plain::bind<&Receiver::addConst>(&receiver));
+    CHECK(Plain(Noexcept()) == Plain());
+
+    CHECK(Plain(function).hash() == Plain(&hitNoexcept).hash());
+    CHECK(!Plain(function).pointsBefore(Plain(&hitNoexcept)));
+    CHECK(!Plain(&hitNoexcept).pointsBefore(Plain(function)));
+
+    std::unordered_set<Plain> set;
+    set.insert(Plain(method));
+    CHECK(set.count(Plain(&receiver, &Receiver::add)) == 1);
+
+    const Plain converted(function);
+    hits = 0;
+    converted(4);
+    CHECK(hits == 4);
+}
+
+int main() {
+    testConstruct();
+    testBind();
+    testConstexpr();
+    testCompare();
+    testRelocate();
+    testNoexcept();
+
+    return testResult();
+}
@@ -0,0 +1,223 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests the C++20 coroutine adapters: CallbackAwaiter, awaitCallback() and
+ * resumeCallback()
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include <exception>
+#include <thread>
+#include <tuple>
+
+#include "callback_coroutine.hpp"
+#include "callback_queue.hpp"
+#include "test.hpp"
+
+// Coroutine which starts right away and frees itself when it finished
+struct Task {
+    struct promise_type {
+        Task get_return_object() { return Task(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+static uint32_t step = 0;
+static int32_t result = 0;
+
+static Task awaitValue(CallbackAwaiter<int32_t> &awaiter) {
+    step = 1;
+    result = co_await awaiter;
+    step = 2;
+}
+
+static Task awaitValues(CallbackAwaiter<int32_t, const int32_t &, bool> &awaiter) {
+    const std::tuple<int32_t, int32_t, bool> values = co_await awaiter;
+    result = std::get<0>(values) + std::get<1>(values) + (std::get<2>(values) ? 100 : 0);
+}
+
+static Task awaitTwice(CallbackAwaiter<> &awaiter) {
+    co_await awaiter;
+    step++;
+    co_await awaiter;
+    step++;
+}
+
+static void testAwaiter() {
+    testCase("CallbackAwaiter completed later");
+
+    step = 0;
+    result = 0;
+    CallbackAwaiter<int32_t> awaiter;
+    const Callback<void, int32_t> done = awaiter.callback();
+
+    awaitValue(awaiter);
+    CHECK(step == 1);
+
+    done(5);
+    CHECK(step == 2);
+    CHECK(result == 5);
+
+    testCase("CallbackAwaiter completed before co_await");
+
+    step = 0;
+    done(7);
+    awaitValue(awaiter);
+    CHECK(step == 2);
+    CHECK(result == 7);
+
+    testCase("Several Arguments");
+
+    CallbackAwaiter<int32_t, const int32_t &, bool> values;
+    awaitValues(values);
+    const int32_t two = 2;
+    values.callback()(1, two, true);
+    CHECK(result == 103);
+
+    testCase("Awaited again");
+
+    step = 0;
+    CallbackAwaiter<> again;
+    awaitTwice(again);
+    CHECK(step == 0);
+    again.callback()();
+    CHECK(step == 1);
+    again.callback()();
+    CHECK(step == 2);
+}
+
+// Counts its living instances
+struct Counted {
+    static int32_t alive;
+
+    Counted() { alive++; }
+    Counted(const Counted &) { alive++; }
+    Counted(Counted &&) { alive++; }
+    ~Counted() { alive--; }
+};
+
+int32_t Counted::alive = 0;
+
+static void testNeverAwaited() {
+    testCase("Completed but never awaited");
+
+    Counted::alive = 0;
+    {
+        CallbackAwaiter<Counted> awaiter;
+        awaiter.callback()(Counted());
+        CHECK(Counted::alive == 1);
+    }
+    CHECK(Counted::alive == 0);
+}
+
+static Callback<void, int32_t> pending;
+
+static Task initiate(const bool immediately) {
+    step = 1;
+    result = co_await awaitCallback<int32_t>([immediately](Callback<void, int32_t> done) {
+        if (immediately) {
+            done(9);
+        } else {
+            pending = done;
+        }
+    });
+    step = 2;
+}
+
+static void testAwaitCallback() {
+    testCase("awaitCallback completed later");
+
+    step = 0;
+    result = 0;
+    initiate(false);
+    CHECK(step == 1);
+    pending(8);
+    CHECK(step == 2);
+    CHECK(result == 8);
+
+    testCase("awaitCallback completed by the initiator");
+
+    step = 0;
+    initiate(true);
+    CHECK(step == 2);
+    CHECK(result == 9);
+}
+
+static CallbackQueue<4> queue;
+
+// Suspends and posts the resumption to the queue
+struct Yield {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(const std::coroutine_handle<> handle) { queue.push(resumeCallback(handle)); }
+    void await_resume() const noexcept {}
+};
+
+static Task yieldTwice() {
+    co_await Yield();
+    step++;
+    co_await Yield();
+    step++;
+}
+
+static void testResumeCallback() {
+    testCase("resumeCallback through a CallbackQueue");
+
+    step = 0;
+    yieldTwice();
+    CHECK(step == 0);
+    CHECK(queue.drain() == 1);
+    CHECK(step == 1);
+    CHECK(queue.drain() == 1);
+    CHECK(step == 2);
+    CHECK(queue.empty());
+}
+
+static std::thread::id resumedOn;
+
+static Task awaitOtherThread(CallbackAwaiter<int32_t> &awaiter) {
+    result = co_await awaiter;
+    resumedOn = std::this_thread::get_id();
+}
+
+static void testOtherThread() {
+    testCase("Completed by another thread");
+
+    for (int32_t i = 0; i < 1000; i++) {
+        result = 0;
+        CallbackAwaiter<int32_t> awaiter;
+        const Callback<void, int32_t> done = awaiter.callback();
+
+        // Races with the coroutine suspending
+        std::thread completer([done, i]() { done(i); });
+        awaitOtherThread(awaiter);
+        completer.join();
+
+        if (!CHECK(result == i)) {
+            break;
+        }
+    }
+
+    // Resumed on the thread of the Callback if it was already suspended
+    result = 0;
+    CallbackAwaiter<int32_t> awaiter;
+    awaitOtherThread(awaiter);
+    std::thread completer([&awaiter]() { awaiter.callback()(42); });
+    const std::thread::id completerId = completer.get_id();
+    completer.join();
+    CHECK(result == 42);
+    CHECK(resumedOn == completerId);
+}
+
+int main() {
+    testAwaiter();
+    testNeverAwaited();
+    testAwaitCallback();
+    testResumeCallback();
+    testOtherThread();
+
+    return testResult();
+}
@@ -0,0 +1,172 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests CallbackExecutor: submit(), submitBatch(), wait(), parallelFor() and full queues
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "callback_executor.hpp"
+#include "callback_unique.hpp"
+#include "test.hpp"
+
+static std::atomic<uint64_t> sum(0);
+
+static void add(uint64_t value) { sum += value; }
+
+static void addOne() { sum++; }
+
+static void testSubmit() {
+    testCase("submit with Arguments");
+
+    sum = 0;
+    {
+        CallbackExecutor<4, 256, Callback<void, uint64_t>> executor;
+
+        for (uint64_t value = 1; value <= 1000; value++) {
+            while (!executor.submit(Callback<void, uint64_t>(&add), value)) {
+                std::this_thread::yield();
+            }
+        }
+
+        executor.wait();
+        CHECK(sum == 1000 * 1001 / 2);
+    }
+
+    testCase("submit move-only tasks");
+
+    sum = 0;
+    {
+        CallbackExecutor<2, 16, UniqueCallback<void, std::unique_ptr<uint64_t>>> executor;
+
+        for (uint64_t value = 1; value <= 10; value++) {
+            CHECK(executor.submit([](std::unique_ptr<uint64_t> owned) { sum += *owned; },
+                                  std::unique_ptr<uint64_t>(new uint64_t(value))));
+        }
+
+        executor.wait();
+        CHECK(sum == 55);
+    }
+
+    testCase("Destructor runs the remaining tasks");
+
+    sum = 0;
+    {
+        CallbackExecutor<2> executor;
+
+        for (uint32_t i = 0; i < 100; i++) {
+            executor.submit(Callback<void>(&addOne));
+        }
+    }
+    CHECK(sum == 100);
+}
+
+static void testSubmitBatch() {
+    testCase("submitBatch");
+
+    sum = 0;
+    CallbackExecutor<3> executor;
+    Callback<void> callbacks[50];
+
+    for (Callback<void> &callback : callbacks) {
+        callback = Callback<void>(&addOne);
+    }
+
+    CHECK(executor.submitBatch(callbacks, 50) == 50);
+    executor.wait();
+    CHECK(sum == 50);
+}
+
+static std::atomic<bool> release(false);
+static std::atomic<bool> started(false);
+
+static void block() {
+    started = true;
+    while (!release.load()) {
+        std::this_thread::yield();
+    }
+}
+
+static void testFull() {
+    testCase("Full queues");
+
+    sum = 0;
+    release = false;
+    started = false;
+
+    CallbackExecutor<1, 2> executor;
+    CHECK(executor.submit(Callback<void>(&block)));
+
+    while (!started.load()) {
+        std::this_thread::yield();
+    }
+
+    // The worker is blocked, only the capacity of its queue is left
+    CHECK(executor.submit(Callback<void>(&addOne)));
+    CHECK(executor.submit(Callback<void>(&addOne)));
+    CHECK(!executor.submit(Callback<void>(&addOne)));
+
+    release = true;
+    executor.wait();
+    CHECK(sum == 2);
+}
+
+using Executor = CallbackExecutor<4>;
+
+static Executor *executor = nullptr;
+
+static const std::size_t indices = 10000;
+static std::atomic<uint32_t> visits[indices];
+
+static void visit(const std::size_t index) { visits[index]++; }
+
+static std::atomic<uint64_t> nestedSum(0);
+
+static void addIndex(const std::size_t index) { nestedSum += index; }
+
+// A parallelFor() from inside a task of the same executor
+static void nested(const std::size_t) { executor->parallelFor(0, 100, &addIndex, 7); }
+
+static void testParallelFor() {
+    testCase("parallelFor");
+
+    Executor pool;
+    executor = &pool;
+
+    for (const std::size_t grain : {(std::size_t)1, (std::size_t)3, (std::size_t)64, indices}) {
+        for (std::atomic<uint32_t> &count : visits) {
+            count = 0;
+        }
+
+        pool.parallelFor(10, indices, &visit, grain);
+
+        bool once = visits[0] == 0 && visits[9] == 0;
+        for (std::size_t i = 10; i < indices; i++) {
+            once = once && visits[i] == 1;
+        }
+        CHECK(once);
+    }
+
+    // Empty range
+    pool.parallelFor(5, 5, &visit);
+    CHECK(visits[5] == 0);
+
+    testCase("Nested parallelFor");
+
+    nestedSum = 0;
+    pool.parallelFor(0, 8, &nested);
+    CHECK(nestedSum == 8 * (99 * 100 / 2));
+}
+
+int main() {
+    testSubmit();
+    testSubmitBatch();
+    testFull();
+    testParallelFor();
+
+    return testResult();
+}
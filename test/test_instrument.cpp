@@ -0,0 +1,109 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests CONFIG_CALLBACK_INSTRUMENT: call counts, ticks and histograms per target and thread
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include <stdint.h>
+
+#include <atomic>
+#include <thread>
+
+// Each timestamp is 4 ticks after the one before, so every call takes exactly 4 ticks
+static std::atomic<uint32_t> ticks(0);
+
+#define CALLBACK_INSTRUMENT_TIMESTAMP() (ticks += 4)
+#define CONFIG_CALLBACK_INSTRUMENT
+
+#include "callback.hpp"
+#include "test.hpp"
+
+static int32_t twice(int32_t value) { return value * 2; }
+
+struct Receiver {
+    int32_t value = 0;
+
+    int32_t get(int32_t offset) const { return value + offset; }
+};
+
+/**
+ * @brief Find the stats of a target
+ *
+ * @param data First word of the data of the target, 0 for targets without data
+ * @param count Only needed for targets without data, which are told apart by their count
+ * @param thread Index of the table
+ * @return CallbackInstrumentStats Zeroed if it was not recorded
+ */
+static CallbackInstrumentStats find(const uintptr_t data, const uint32_t count,
+                                    const std::size_t thread = 0) {
+    CallbackInstrumentStats found = {};
+
+    CallbackInstrument<>::forEach([&](const CallbackInstrumentStats &stats) {
+        if (stats.data[0] == data && stats.thread == thread &&
+            (data != 0 || stats.count == count)) {
+            found = stats;
+        }
+    });
+
+    return found;
+}
+
+static void testRecord() {
+    testCase("Calls per target");
+
+    Receiver first, second;
+    const Callback<int32_t, int32_t> function(&twice);
+    const Callback<int32_t, int32_t> firstGet(&first, &Receiver::get);
+    const Callback<int32_t, int32_t> secondGet(&second, &Receiver::get);
+
+    for (uint32_t i = 0; i < 5; i++) {
+        function(1);
+    }
+
+    for (uint32_t i = 0; i < 3; i++) {
+        firstGet(1);
+    }
+
+    // bindFront() records nothing itself, the Callback it forwards to records the call
+    secondGet.bindFront(1)();
+    secondGet(1);
+
+    // Functors are only told apart by their type
+    for (int32_t i = 0; i < 7; i++) {
+        const Callback<int32_t, int32_t> lambda = [i](int32_t value) { return value + i; };
+        lambda(1);
+    }
+
+    const CallbackInstrumentStats functionStats = find((uintptr_t)&twice, 0);
+    CHECK(functionStats.count == 5);
+    CHECK(functionStats.totalTicks == 5 * 4);
+    CHECK(functionStats.maxTicks == 4);
+    CHECK(functionStats.histogram[3] == 5);
+
+    CHECK(find((uintptr_t)&first, 0).count == 3);
+    CHECK(find((uintptr_t)&second, 0).count == 2);
+    CHECK(find(0, 7).count == 7);
+
+    testCase("Calls per thread");
+
+    std::thread other([&function]() { function(1); });
+    other.join();
+
+    CHECK(find((uintptr_t)&twice, 0).count == 5);
+    CHECK(find((uintptr_t)&twice, 0, 1).count == 1);
+    CHECK(CallbackInstrument<>::dropped() == 0);
+
+    // Empty Callbacks are not recorded
+    Callback<int32_t, int32_t>()(1);
+    uint32_t entries = 0;
+    CallbackInstrument<>::forEach([&entries](const CallbackInstrumentStats &) { entries++; });
+    CHECK(entries == 5);
+}
+
+int main() {
+    testRecord();
+
+    return testResult();
+}
@@ -0,0 +1,190 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests CallbackList: emit(), the Combiners and changes from Callbacks and other threads
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "callback_list.hpp"
+#include "test.hpp"
+
+static uint32_t calls = 0;
+
+static uint32_t addOne(uint32_t value) {
+    calls++;
+    return value + 1;
+}
+
+static uint32_t addTwo(uint32_t value) {
+    calls++;
+    return value + 2;
+}
+
+static uint32_t zero(uint32_t) {
+    calls++;
+    return 0;
+}
+
+static void testEmit() {
+    testCase("emit");
+
+    CallbackList<2, uint32_t, uint32_t> list;
+    CHECK(list.size() == 0);
+    CHECK(list.add(Callback<uint32_t, uint32_t>(&addOne)));
+    CHECK(list.add(Callback<uint32_t, uint32_t>(&addTwo)));
+    CHECK(!list.add(Callback<uint32_t, uint32_t>(&zero)));
+    CHECK(list.size() == 2);
+
+    calls = 0;
+    list.emit(1);
+    CHECK(calls == 2);
+
+    calls = 0;
+    list(1);
+    CHECK(calls == 2);
+
+#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
+    CHECK(list.remove(Callback<uint32_t, uint32_t>(&addOne)));
+    CHECK(!list.remove(Callback<uint32_t, uint32_t>(&addOne)));
+    CHECK(list.size() == 1);
+#endif
+
+    CHECK(list.clear());
+    CHECK(list.size() == 0);
+
+    calls = 0;
+    list.emit(1);
+    CHECK(calls == 0);
+}
+
+static void testCombiners() {
+    testCase("Combiners");
+
+    CallbackList<4, uint32_t, uint32_t> list;
+    CHECK(list.emit<CallbackSum>(1) == 0);
+    CHECK(list.emit<CallbackLast>(1) == 0);
+    CHECK(!list.emit<CallbackFirstTrue>(1));
+    CHECK(list.emit<CallbackCollect<4>>(1).count == 0);
+
+    list.add(Callback<uint32_t, uint32_t>(&zero));
+    list.add(Callback<uint32_t, uint32_t>(&addOne));
+    list.add(Callback<uint32_t, uint32_t>(&addTwo));
+
+    CHECK(list.emit<CallbackSum>(1) == 0 + 2 + 3);
+    CHECK(list.emit<CallbackLast>(1) == 3);
+
+    // Stops at addOne, addTwo is not called
+    calls = 0;
+    CHECK(list.emit<CallbackFirstTrue>(1));
+    CHECK(calls == 2);
+
+    const CallbackResults<uint32_t, 4> all = list.emit<CallbackCollect<4>>(1);
+    CHECK(all.count == 3);
+    CHECK(all.values[0] == 0 && all.values[1] == 2 && all.values[2] == 3);
+
+    calls = 0;
+    const CallbackResults<uint32_t, 2> first = list.emit<CallbackCollect<2>>(1);
+    CHECK(first.count == 2);
+    CHECK(calls == 2);
+}
+
+// List changed by its own Callback (once per emit) and by another thread at the same time
+using ChangedList = CallbackList<8, void, uint32_t>;
+
+static ChangedList *changedList = nullptr;
+static uint32_t changes = 0;
+
+static void noop(uint32_t) {}
+
+static void changeList(uint32_t) { changedList->add(Callback<void, uint32_t>(&noop)); }
+
+static void changeListTwice(uint32_t) {
+    if (changedList->add(Callback<void, uint32_t>(&noop))) {
+        changes++;
+    }
+
+    // Only one change per emit()
+    CHECK(!changedList->clear());
+}
+
+static void testChangeFromCallback() {
+    testCase("Change from a Callback");
+
+    ChangedList list;
+    changedList = &list;
+    changes = 0;
+
+    list.add(Callback<void, uint32_t>(&changeListTwice));
+    list.emit(0);
+
+    CHECK(changes == 1);
+    CHECK(list.size() == 2);
+}
+
+/**
+ * @brief Check that a Callback changing its list does not deadlock with a writer on another
+ * thread, which waits for the emit() of the Callback to finish
+ *
+ */
+static void testWriters() {
+    testCase("Changed by its Callback and another thread");
+
+    // Leaked on purpose, the threads are detached if they hang
+    changedList = new ChangedList();
+    std::atomic<bool> *const stop = new std::atomic<bool>(false);
+    std::atomic<uint64_t> *const progress = new std::atomic<uint64_t>(0);
+
+    std::thread emitter([stop, progress]() {
+        while (!stop->load()) {
+            changedList->clear();
+            changedList->add(Callback<void, uint32_t>(&changeList));
+            changedList->emit(0);
+            progress->fetch_add(1);
+        }
+    });
+
+    std::thread writer([stop, progress]() {
+        while (!stop->load()) {
+            changedList->add(Callback<void, uint32_t>(&noop));
+            progress->fetch_add(1);
+        }
+    });
+
+    bool ok = true;
+
+    for (uint32_t i = 0; i < 10 && ok; i++) {
+        const uint64_t before = progress->load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        ok = progress->load() != before;
+    }
+
+    stop->store(true);
+
+    if (!CHECK(ok)) {
+        printf("Deadlocked\n");
+        emitter.detach();
+        writer.detach();
+        return;
+    }
+
+    emitter.join();
+    writer.join();
+
+    delete progress;
+    delete stop;
+    delete changedList;
+}
+
+int main() {
+    testEmit();
+    testCombiners();
+    testChangeFromCallback();
+    testWriters();
+
+    return testResult();
+}
@@ -0,0 +1,184 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests marshalled Callbacks: on(), bindOn() and MarshalledCallback round trips through a
+ * mailbox, full mailboxes and futures completed by another thread
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+// Counts the calls of on() and bindOn() Callbacks dropped by a full mailbox
+static uint32_t dropped = 0;
+
+#define CALLBACK_MARSHAL_DROPPED() dropped++
+
+#include "callback_marshal.hpp"
+#include "test.hpp"
+
+static int32_t sum = 0;
+
+static void add(int32_t value) { sum += value; }
+
+static int32_t twice(int32_t value) { return value * 2; }
+
+struct Driver {
+    int32_t value = 0;
+
+    void set(int32_t other) { value = other; }
+    int32_t get(int32_t offset) const { return value + offset; }
+};
+
+using Mailbox = CallbackMailbox<4>;
+using Setter = Callback<void, int32_t>;
+using Getter = Callback<int32_t, int32_t>;
+
+static void testRoundTrip() {
+    testCase("on() and bindOn() round trip");
+
+    Mailbox mailbox;
+    Driver driver;
+    sum = 0;
+
+    const auto onAdd = Setter(&add).on(mailbox);
+    onAdd(1);
+    onAdd(2);
+
+    // Fits the default buffer
+    const Setter onSet = Setter::bindOn<Driver, &Driver::set>(&driver, mailbox);
+    onSet(5);
+
+    // Nothing runs before the owner drains its mailbox, the Arguments are copies
+    CHECK(sum == 0);
+    CHECK(driver.value == 0);
+    CHECK(mailbox.drain() == 3);
+    CHECK(sum == 3);
+    CHECK(driver.value == 5);
+
+    // A Callback with a result returns Return() at once
+    const auto onTwice = Getter(&twice).on(mailbox);
+    CHECK(onTwice(4) == 0);
+    CHECK(mailbox.drain() == 1);
+
+    CHECK(!Setter().on(mailbox).isCallbackSet());
+
+    testCase("MarshalledCallback with a future");
+
+    CallbackFuture<int32_t> result;
+    CHECK(!result.ready() && !result.dropped());
+
+    const auto marshalled = marshalledCallback(mailbox, Getter(&driver, &Driver::get));
+    CHECK(marshalled.post(result, 1));
+    CHECK(!result.ready());
+    CHECK(mailbox.drain() == 1);
+    CHECK(result.ready());
+    CHECK(result.get() == 6);
+
+    // Reused after reset()
+    result.reset();
+    CHECK(!result.ready());
+    CHECK(marshalled.post(result, 2));
+    mailbox.drain();
+    CHECK(result.get() == 7);
+
+    CallbackFuture<void> done;
+    CHECK(marshalledCallback(mailbox, Setter(&add)).post(done, 10));
+    mailbox.drain();
+    CHECK(done.ready());
+    CHECK(sum == 13);
+
+    // Move-only Arguments
+    CallbackFuture<int32_t> owned;
+    const auto take = marshalledCallback(
+        mailbox, Callback<int32_t, std::unique_ptr<int32_t>>(
+                     [](std::unique_ptr<int32_t> value) { return *value; }));
+    CHECK(take.post(owned, std::unique_ptr<int32_t>(new int32_t(9))));
+    mailbox.drain();
+    CHECK(owned.get() == 9);
+}
+
+static void testFull() {
+    testCase("Full mailbox");
+
+    Mailbox mailbox;
+    Driver driver;
+    sum = 0;
+    dropped = 0;
+
+    const auto marshalled = marshalledCallback(mailbox, Setter(&add));
+    for (int32_t i = 0; i < 4; i++) {
+        CHECK(marshalled.post(1));
+    }
+
+    // A failed post drops the future, waiting for it returns at once
+    CallbackFuture<void> future;
+    CHECK(!marshalled.post(future, 1));
+    CHECK(future.dropped());
+    CHECK(!future.ready());
+    future.wait();
+
+    CallbackFuture<int32_t> result;
+    CHECK(!marshalledCallback(mailbox, Getter(&twice)).post(result, 1));
+    CHECK(result.dropped());
+
+    // on() and bindOn() Callbacks report the drop through CALLBACK_MARSHAL_DROPPED()
+    Setter(&add).on(mailbox)(1);
+    Setter::bindOn<Driver, &Driver::set>(&driver, mailbox)(1);
+    CHECK(dropped == 2);
+
+    CHECK(mailbox.drain() == 4);
+    CHECK(sum == 4);
+    CHECK(driver.value == 0);
+
+    // Posted again after the drain
+    CHECK(marshalled.post(future, 1));
+    CHECK(!future.dropped());
+    mailbox.drain();
+    CHECK(future.ready());
+}
+
+static void testThreads() {
+    testCase("Futures completed by the owner thread");
+
+    static Mailbox mailbox;
+    std::atomic<bool> stop(false);
+
+    std::thread owner([&stop]() {
+        while (!stop.load()) {
+            if (mailbox.drain() == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    const auto marshalled = marshalledCallback(mailbox, Getter(&twice));
+    bool correct = true;
+
+    for (int32_t i = 0; i < 1000; i++) {
+        CallbackFuture<int32_t> result;
+
+        while (!marshalled.post(result, i)) {
+            std::this_thread::yield();
+        }
+
+        correct = correct && result.get() == i * 2;
+    }
+
+    stop = true;
+    owner.join();
+
+    CHECK(correct);
+}
+
+int main() {
+    testRoundTrip();
+    testFull();
+    testThreads();
+
+    return testResult();
+}
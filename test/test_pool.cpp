@@ -0,0 +1,184 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests CallbackPool and PooledCallback: inline and allocated Functors, copies, moves,
+ * destruction, exhausted pools and blocks shared by several threads
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include <string.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "callback_pool.hpp"
+#include "test.hpp"
+
+// Counts its living instances, so a Functor holding it is not trivially destructible
+struct Counted {
+    static int32_t alive;
+
+    Counted() { alive++; }
+    Counted(const Counted &) { alive++; }
+    ~Counted() { alive--; }
+};
+
+int32_t Counted::alive = 0;
+
+struct Big {
+    uint8_t data[100];
+};
+
+static void testPooled() {
+    testCase("Inline and allocated Functors");
+
+    const uint32_t offset = 2;
+    PooledCallback<uint32_t, uint32_t> small = [offset](uint32_t value) { return value + offset; };
+    CHECK(small.isCallbackSet());
+    CHECK(!small.isAllocated());
+    CHECK(small(1) == 3);
+
+    Big big;
+    memset(big.data, 1, sizeof(big.data));
+    PooledCallback<uint32_t, uint32_t> large = [big](uint32_t index) { return big.data[index]; };
+    CHECK(large.isAllocated());
+    CHECK(large(99) == 1);
+    CHECK(large.callback()(0) == 1);
+
+    testCase("Copy, move and destroy");
+
+    Counted::alive = 0;
+    {
+        const Counted counted;
+        PooledCallback<int32_t> original = [counted]() { return Counted::alive; };
+        CHECK(original.isAllocated());
+        CHECK(Counted::alive == 2);
+
+        PooledCallback<int32_t> copy(original);
+        CHECK(copy.isAllocated());
+        CHECK(Counted::alive == 3);
+        CHECK(copy() == 3);
+
+        PooledCallback<int32_t> moved(std::move(copy));
+        CHECK(!copy.isCallbackSet());
+        CHECK(!copy.isAllocated());
+        CHECK(moved() == 3);
+
+        copy = moved;
+        CHECK(Counted::alive == 4);
+        moved = PooledCallback<int32_t>();
+        CHECK(Counted::alive == 3);
+        CHECK(copy() == 3);
+
+        original = std::move(copy);
+        CHECK(Counted::alive == 2);
+        CHECK(original() == 2);
+    }
+    CHECK(Counted::alive == 0);
+}
+
+// Allocator with a pool of two blocks
+struct SmallAllocator {
+    using Pool = CallbackPool<128, 2>;
+
+    template <std::size_t Size, std::size_t Align>
+    static inline void *allocate() {
+        return Pool::allocate();
+    }
+
+    template <std::size_t Size, std::size_t Align>
+    static inline void deallocate(void *const block) {
+        Pool::deallocate(block);
+    }
+};
+
+static void testExhausted() {
+    testCase("Exhausted pool");
+
+    Big big = {};
+    big.data[0] = 5;
+    auto functor = [big]() { return big.data[0]; };
+
+    {
+        AllocatedCallback<SmallAllocator, uint8_t> first = functor;
+        AllocatedCallback<SmallAllocator, uint8_t> second = functor;
+        AllocatedCallback<SmallAllocator, uint8_t> third = functor;
+        CHECK(first.isAllocated() && second.isAllocated());
+        CHECK(!third.isCallbackSet());
+        CHECK(third() == 0);
+
+        AllocatedCallback<SmallAllocator, uint8_t> copy(first);
+        CHECK(!copy.isCallbackSet());
+    }
+
+    // All blocks are free again
+    AllocatedCallback<SmallAllocator, uint8_t> first = functor;
+    AllocatedCallback<SmallAllocator, uint8_t> second = functor;
+    CHECK(first() == 5 && second() == 5);
+}
+
+using SharedPool = CallbackPool<64, 64>;
+
+/**
+ * @brief Threads take blocks and give back blocks taken by other threads. Every block is marked by
+ * its owner, a block handed out twice at the same time is overwritten.
+ *
+ */
+static void testThreads() {
+    testCase("Blocks shared by several threads");
+
+    static const uint32_t threadCount = 4;
+    std::atomic<void *> exchanged[threadCount];
+    std::atomic<bool> unique(true);
+    std::vector<std::thread> threads;
+
+    for (std::atomic<void *> &block : exchanged) {
+        block = nullptr;
+    }
+
+    for (uint32_t t = 0; t < threadCount; t++) {
+        threads.emplace_back([t, &exchanged, &unique]() {
+            for (uint32_t i = 0; i < 20000; i++) {
+                uint32_t *const block = (uint32_t *)SharedPool::allocate();
+                if (block == nullptr) {
+                    continue;
+                }
+
+                *block = t;
+                for (uint32_t spin = 0; spin < 10; spin++) {
+                    if (*(volatile uint32_t *)block != t) {
+                        unique = false;
+                    }
+                }
+
+                // Hand the block to the next thread, give back the one it handed over
+                void *const other = exchanged[(t + 1) % threadCount].exchange(block);
+                if (other != nullptr) {
+                    SharedPool::deallocate(other);
+                }
+            }
+        });
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    for (std::atomic<void *> &block : exchanged) {
+        if (block.load() != nullptr) {
+            SharedPool::deallocate(block.load());
+        }
+    }
+
+    CHECK(unique);
+}
+
+int main() {
+    testPooled();
+    testExhausted();
+    testThreads();
+
+    return testResult();
+}
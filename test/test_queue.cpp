@@ -0,0 +1,187 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests CallbackQueue, MpscCallbackQueue and MpmcCallbackQueue: order, capacity, stored
+ * Arguments and concurrent producers and consumers
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "callback_queue.hpp"
+#include "callback_unique.hpp"
+#include "test.hpp"
+
+static uint32_t order[4];
+static uint32_t calls = 0;
+
+static void record(uint32_t value) { order[calls++] = value; }
+
+static void increment(uint32_t &value) { value++; }
+
+static uint32_t seen = 0;
+
+static void see(const uint32_t &value) { seen = value; }
+
+// Counts its living instances
+struct Counted {
+    static int32_t alive;
+
+    Counted() { alive++; }
+    Counted(const Counted &) { alive++; }
+    ~Counted() { alive--; }
+};
+
+int32_t Counted::alive = 0;
+
+static void takeCounted(Counted) {}
+
+template <template <std::size_t, typename> class Queue>
+static void testQueue(const char *const name) {
+    testCase(name);
+
+    {
+        Queue<4, Callback<void, uint32_t>> queue;
+        CHECK(queue.empty());
+
+        for (uint32_t i = 0; i < 4; i++) {
+            CHECK(queue.push(Callback<void, uint32_t>(&record), i));
+        }
+        CHECK(!queue.push(Callback<void, uint32_t>(&record), 4));
+        CHECK(!queue.empty());
+
+        calls = 0;
+        CHECK(queue.drain(1) == 1);
+        CHECK(queue.drain() == 3);
+        CHECK(queue.drain() == 0);
+        CHECK(queue.empty());
+        CHECK(calls == 4);
+        CHECK(order[0] == 0 && order[1] == 1 && order[2] == 2 && order[3] == 3);
+
+        // Wraps around
+        for (uint32_t round = 0; round < 3; round++) {
+            calls = 0;
+            CHECK(queue.push(Callback<void, uint32_t>(&record), round));
+            CHECK(queue.push(Callback<void, uint32_t>(&record), round + 1));
+            CHECK(queue.push(Callback<void, uint32_t>(&record), round + 2));
+            CHECK(queue.drain() == 3);
+            CHECK(order[0] == round && order[1] == round + 1 && order[2] == round + 2);
+        }
+    }
+
+    {
+        // Non-const references refer to the object of the caller, const ones are copied
+        uint32_t value = 1;
+        Queue<4, Callback<void, uint32_t &>> references;
+        CHECK(references.push(Callback<void, uint32_t &>(&increment), value));
+        CHECK(references.push(Callback<void, uint32_t &>(&increment), value));
+        references.drain();
+        CHECK(value == 3);
+
+        Queue<4, Callback<void, const uint32_t &>> constReferences;
+        CHECK(constReferences.push(Callback<void, const uint32_t &>(&see), value));
+        value = 0;
+        constReferences.drain();
+        CHECK(seen == 3);
+    }
+
+    {
+        // Move-only Callbacks and Arguments are moved through the queue
+        Queue<4, UniqueCallback<void, std::unique_ptr<uint32_t>>> unique;
+        uint32_t result = 0;
+        CHECK(unique.push([&result](std::unique_ptr<uint32_t> value) { result = *value; },
+                          std::unique_ptr<uint32_t>(new uint32_t(5))));
+        CHECK(unique.drain() == 1);
+        CHECK(result == 5);
+    }
+
+    {
+        // Arguments are destroyed after the call and with the queue if never called
+        Counted::alive = 0;
+        {
+            Queue<4, Callback<void, Counted>> queue;
+            queue.push(Callback<void, Counted>(&takeCounted), Counted());
+            queue.push(Callback<void, Counted>(&takeCounted), Counted());
+            CHECK(Counted::alive == 2);
+            queue.drain(1);
+            CHECK(Counted::alive == 1);
+        }
+        CHECK(Counted::alive == 0);
+    }
+}
+
+static std::atomic<uint64_t> sum(0);
+
+static void add(uint64_t value) { sum += value; }
+
+static const uint64_t pushes = 20000;
+static const uint64_t pushedSum = pushes * (pushes + 1) / 2;
+
+/**
+ * @brief Push 1 to pushes from each producer, until all are drained by the consumers
+ *
+ * @tparam Q
+ * @param queue
+ * @param producers
+ * @param consumers
+ */
+template <typename Q>
+static void stress(Q &queue, const uint32_t producers, const uint32_t consumers) {
+    std::vector<std::thread> threads;
+    std::atomic<uint64_t> drained(0);
+    sum = 0;
+
+    for (uint32_t i = 0; i < producers; i++) {
+        threads.emplace_back([&queue]() {
+            for (uint64_t value = 1; value <= pushes; value++) {
+                while (!queue.push(Callback<void, uint64_t>(&add), value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (uint32_t i = 0; i < consumers; i++) {
+        threads.emplace_back([&queue, &drained, producers]() {
+            while (drained.load() < producers * pushes) {
+                const std::size_t count = queue.drain();
+                if (count == 0) {
+                    std::this_thread::yield();
+                }
+                drained += count;
+            }
+        });
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    CHECK(drained == producers * pushes);
+    CHECK(sum == producers * pushedSum);
+    CHECK(queue.empty());
+}
+
+int main() {
+    testQueue<CallbackQueue>("CallbackQueue");
+    testQueue<MpscCallbackQueue>("MpscCallbackQueue");
+    testQueue<MpmcCallbackQueue>("MpmcCallbackQueue");
+
+    testCase("CallbackQueue with one producer and one consumer");
+    static CallbackQueue<64, Callback<void, uint64_t>> spsc;
+    stress(spsc, 1, 1);
+
+    testCase("MpscCallbackQueue with four producers");
+    static MpscCallbackQueue<64, Callback<void, uint64_t>> mpsc;
+    stress(mpsc, 4, 1);
+
+    testCase("MpmcCallbackQueue with three producers and three consumers");
+    static MpmcCallbackQueue<64, Callback<void, uint64_t>> mpmc;
+    stress(mpmc, 3, 3);
+
+    return testResult();
+}
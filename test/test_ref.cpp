@@ -0,0 +1,78 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests CallbackRef: Functions, Functors, Callbacks, Methods bound at compile time and
+ * Methods given at runtime
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include <memory>
+
+#include "callback_ref.hpp"
+#include "test.hpp"
+
+static int32_t twice(int32_t value) { return value * 2; }
+
+struct Visitor {
+    int32_t sum = 0;
+
+    int32_t visit(int32_t value) { return sum += value; }
+    int32_t peek(int32_t value) const { return sum + value; }
+};
+
+// Calls visitor for 1 to 4 and returns the last result, like an algorithm taking a CallbackRef
+static int32_t forEach(const CallbackRef<int32_t, int32_t> visitor) {
+    int32_t result = 0;
+
+    for (int32_t i = 1; i <= 4; i++) {
+        result = visitor(i);
+    }
+
+    return result;
+}
+
+static void testRef() {
+    testCase("Functions, Functors and Callbacks");
+
+    CHECK(forEach(&twice) == 8);
+    CHECK(forEach(nullptr) == 0);
+
+    int32_t total = 0;
+    CHECK(forEach([&total](int32_t value) { return total += value; }) == 10);
+    CHECK(total == 10);
+
+    const Callback<int32_t, int32_t> callback(&twice);
+    CHECK(forEach(callback) == 8);
+
+    // Move-only Arguments are forwarded
+    const CallbackRef<int32_t, std::unique_ptr<int32_t>> take = [](std::unique_ptr<int32_t> v) {
+        return *v;
+    };
+    CHECK(take(std::unique_ptr<int32_t>(new int32_t(3))) == 3);
+
+    testCase("Methods");
+
+    Visitor visitor;
+    const Visitor &constVisitor = visitor;
+
+    CHECK((forEach(CallbackRef<int32_t, int32_t>::bind<Visitor, &Visitor::visit>(&visitor)) ==
+           10));
+    CHECK((forEach(CallbackRef<int32_t, int32_t>::bind<Visitor, &Visitor::peek>(&constVisitor)) ==
+           14));
+#ifdef __cpp_nontype_template_parameter_auto
+    CHECK(forEach(CallbackRef<int32_t, int32_t>::bind<&Visitor::peek>(&constVisitor)) == 14);
+#endif
+
+    // Referenced, not copied
+    CHECK(visitor.sum == 10);
+
+    CHECK(forEach(callbackRefMethod(&visitor, &Visitor::visit)) == 20);
+    CHECK(forEach(callbackRefMethod(constVisitor, &Visitor::peek)) == 24);
+}
+
+int main() {
+    testRef();
+
+    return testResult();
+}
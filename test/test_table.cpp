@@ -0,0 +1,109 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests CallbackTable and CallbackRegistry: dispatch, fallbacks and unknown keys or handles
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include "callback_registry.hpp"
+#include "callback_table.hpp"
+#include "test.hpp"
+
+enum class Opcode : uint8_t { Ping, Data, Reset, Unused };
+
+static int32_t onPing(int32_t value) { return value + 1; }
+static int32_t onData(int32_t value) { return value * 10; }
+static int32_t onUnknown(int32_t value) { return -value; }
+
+using Handlers = CallbackTable<Opcode, 4, int32_t, int32_t>;
+
+// Constant data, built at compile time
+static constexpr Handlers handlers(Handlers::entry(Opcode::Data, Handlers::CallbackT(&onData)),
+                                   Handlers::fallback(Handlers::CallbackT(&onUnknown)),
+                                   Handlers::entry(Opcode::Ping, Handlers::CallbackT(&onPing)));
+
+static constexpr Handlers withoutFallback(
+    Handlers::entry(Opcode::Ping, Handlers::CallbackT::bind<&onPing>()));
+
+static void testTable() {
+    testCase("CallbackTable dispatch and fallback");
+
+    static_assert(Handlers::size() == 4, "A key per opcode");
+
+    CHECK(handlers.dispatch(Opcode::Ping, 1) == 2);
+    CHECK(handlers(Opcode::Data, 2) == 20);
+    CHECK(handlers[Opcode::Data](3) == 30);
+
+    // Keys without an entry and out of range keys go to the fallback
+    CHECK(handlers.dispatch(Opcode::Reset, 4) == -4);
+    CHECK(handlers.dispatch((Opcode)200, 5) == -5);
+    CHECK(handlers[(Opcode)4](6) == -6);
+
+    CHECK(handlers.contains(Opcode::Ping));
+    CHECK(!handlers.contains(Opcode::Reset));
+    CHECK(!handlers.contains((Opcode)200));
+
+    // The default fallback is an empty Callback
+    CHECK(withoutFallback.dispatch(Opcode::Ping, 1) == 2);
+    CHECK(withoutFallback.dispatch(Opcode::Data, 1) == 0);
+    CHECK(!withoutFallback[Opcode::Unused].isCallbackSet());
+
+    testCase("CallbackTable built at runtime");
+
+    // The first Entry of a key is taken, out of range keys are ignored
+    int32_t offset = 100;
+    const Handlers runtime(
+        Handlers::entry(Opcode::Ping, [&offset](int32_t value) { return value + offset; }),
+        Handlers::entry(Opcode::Ping, Handlers::CallbackT(&onData)),
+        Handlers::entry((Opcode)9, Handlers::CallbackT(&onData)));
+
+    CHECK(runtime.dispatch(Opcode::Ping, 1) == 101);
+    CHECK(runtime.dispatch(Opcode::Data, 1) == 0);
+}
+
+static void testRegistry() {
+    testCase("CallbackRegistry add, set and remove");
+
+    CallbackRegistry<3, int32_t, int32_t> registry;
+    static_assert(CallbackRegistry<3, int32_t, int32_t>::capacity() == 3, "3 ids");
+
+    const CallbackHandle ping = registry.add(&onPing);
+    const CallbackHandle data = registry.add(&onData);
+    CHECK(ping == CallbackHandle(0));
+    CHECK(data == CallbackHandle(1));
+    CHECK(!registry.add(Callback<int32_t, int32_t>()).isValid());
+
+    CHECK(registry.set(CallbackHandle(2), &onUnknown));
+    CHECK(!registry.set(CallbackHandle(3), &onUnknown));
+    CHECK(!registry.add(&onPing).isValid());
+
+    CHECK(registry.contains(data));
+    registry.remove(data);
+    CHECK(!registry.contains(data));
+    CHECK(registry.add(&onData) == data);
+
+    testCase("CallbackRegistry dispatch");
+
+    CHECK(registry.dispatch(ping, 1) == 2);
+    CHECK(registry(data, 2) == 20);
+    CHECK(registry.resolve(CallbackHandle(2))(3) == -3);
+
+    // Unknown handles call an empty Callback
+    CHECK(registry.dispatch(CallbackHandle(), 4) == 0);
+    CHECK(registry.dispatch(CallbackHandle(7), 4) == 0);
+    CHECK(!registry.resolve(CallbackHandle(7)).isCallbackSet());
+    CHECK(!registry.contains(CallbackHandle()));
+
+    // A plain value, e.g. read from shared memory
+    const CallbackRegistry<3, int32_t, int32_t>::Call call(data, 5);
+    CHECK(registry.dispatch(call) == 50);
+    CHECK(registry.dispatch(CallbackRegistry<3, int32_t, int32_t>::Call()) == 0);
+}
+
+int main() {
+    testTable();
+    testRegistry();
+
+    return testResult();
+}
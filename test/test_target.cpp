@@ -0,0 +1,157 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests CallbackTarget and trackedCallback(): disarming on destruction, slot reuse, a full
+ * table and targets created and destroyed by several threads
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+// The default of MCUs, so the table can be filled
+#define CONFIG_CALLBACK_TARGET_SLOTS 32
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "callback_target.hpp"
+#include "test.hpp"
+
+struct Receiver : public CallbackTarget {
+    uint32_t value = 3;
+
+    uint32_t get() const { return value; }
+    uint32_t add(uint32_t other) { return value += other; }
+};
+
+static void testTracked() {
+    testCase("Disarmed on destruction");
+
+    Callback<uint32_t> get;
+    Callback<uint32_t, uint32_t> add;
+    Callback<uint32_t> getStatic;
+    {
+        Receiver receiver;
+        get = trackedCallback(&receiver, &Receiver::get);
+        add = trackedCallback(receiver, &Receiver::add);
+        getStatic = trackedCallback<decltype(&Receiver::get), &Receiver::get>(&receiver);
+
+        CHECK(receiver.callbackHandle().isAlive());
+        CHECK(receiver.callbackHandle().target() == &receiver);
+        CHECK(get() == 3);
+        CHECK(add(2) == 5);
+        CHECK(getStatic() == 5);
+    }
+
+    CHECK(get() == 0);
+    CHECK(add(2) == 0);
+    CHECK(getStatic() == 0);
+
+    Receiver *const null = nullptr;
+    CHECK(!trackedCallback(null, &Receiver::get).isCallbackSet());
+    CHECK(!CallbackTargetHandle().isAlive());
+}
+
+static void testReuse() {
+    testCase("Slot reuse");
+
+    Receiver *first = new Receiver();
+    const CallbackTargetHandle handle = first->callbackHandle();
+    const Callback<uint32_t> get = trackedCallback(first, &Receiver::get);
+    delete first;
+
+    // The next targets take the released slot, the old handle stays dead
+    for (uint32_t i = 0; i < 100; i++) {
+        Receiver receiver;
+        CHECK(!handle.isAlive());
+        CHECK(get() == 0);
+        CHECK(trackedCallback(&receiver, &Receiver::get)() == 3);
+    }
+
+    testCase("Copies are targets of their own");
+
+    Receiver original;
+    original.value = 7;
+    Receiver copy(original);
+    const Callback<uint32_t> getOriginal = trackedCallback(&original, &Receiver::get);
+    copy.value = 8;
+    copy = original;
+
+    CHECK(copy.callbackHandle().target() == &copy);
+    CHECK(getOriginal() == 7);
+}
+
+static void testFull() {
+    testCase("Full table");
+
+    std::vector<std::unique_ptr<Receiver>> receivers;
+
+    // Some slots may be held by targets of other tests
+    for (uint32_t i = 0; i < CONFIG_CALLBACK_TARGET_SLOTS + 1; i++) {
+        receivers.emplace_back(new Receiver());
+    }
+
+    // Not tracked, so no Callback which is set but never calls is handed out
+    Receiver &last = *receivers.back();
+    CHECK(!last.isTracked());
+    CHECK(!last.callbackHandle().isAlive());
+    CHECK(!trackedCallback(&last, &Receiver::get).isCallbackSet());
+    CHECK(!trackedCallback(last, &Receiver::add).isCallbackSet());
+    CHECK((!trackedCallback<decltype(&Receiver::get), &Receiver::get>(&last).isCallbackSet()));
+    CHECK(receivers.front()->isTracked());
+
+    receivers.clear();
+
+    Receiver receiver;
+    CHECK(receiver.isTracked());
+    CHECK(receiver.callbackHandle().isAlive());
+    CHECK(trackedCallback(&receiver, &Receiver::get)() == 3);
+}
+
+static void testThreads() {
+    testCase("Targets of several threads");
+
+    std::atomic<bool> dead(true);
+    std::vector<std::thread> threads;
+
+    for (uint32_t t = 0; t < 4; t++) {
+        threads.emplace_back([&dead]() {
+            for (uint32_t i = 0; i < 20000; i++) {
+                Callback<uint32_t> get;
+                {
+                    Receiver receiver;
+                    get = trackedCallback(&receiver, &Receiver::get);
+                    if (get() != 3) {
+                        dead = false;
+                    }
+                }
+                if (get() != 0) {
+                    dead = false;
+                }
+            }
+        });
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    CHECK(dead);
+
+    // All slots were given back
+    std::vector<std::unique_ptr<Receiver>> receivers;
+    for (uint32_t i = 0; i < CONFIG_CALLBACK_TARGET_SLOTS; i++) {
+        receivers.emplace_back(new Receiver());
+        CHECK(receivers.back()->callbackHandle().isAlive());
+    }
+}
+
+int main() {
+    testTracked();
+    testReuse();
+    testFull();
+    testThreads();
+
+    return testResult();
+}
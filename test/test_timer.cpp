@@ -0,0 +1,160 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests CallbackTimerWheel: expiry ticks across all levels, canceling, handles and
+ * rescheduling from a Callback
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include "callback_timer.hpp"
+#include "test.hpp"
+
+// Small wheel, so few ticks already cascade through all levels, maxDelay is 63
+using Wheel = CallbackTimerWheel<64, 2, 3>;
+
+static Wheel *wheel = nullptr;
+
+struct Timer {
+    uint64_t expiry = 0;
+    uint64_t fired = 0;
+    uint32_t calls = 0;
+
+    void fire() {
+        fired = wheel->now();
+        calls++;
+    }
+};
+
+static void testExpiry() {
+    testCase("Expiry");
+
+    Wheel timers(5);
+    wheel = &timers;
+
+    static Timer entries[64];
+
+    for (uint64_t i = 0; i < 64; i++) {
+        entries[i] = Timer();
+        entries[i].expiry = timers.now() + (i == 0 ? 1 : i);
+        const CallbackTimerHandle handle =
+            timers.schedule(Callback<void>(&entries[i], &Timer::fire), i);
+        CHECK(timers.isScheduled(handle));
+    }
+
+    CHECK(timers.size() == 64);
+    CHECK(!timers.isScheduled(timers.schedule(Callback<void>(), 1)));
+
+    std::size_t called = 0;
+    for (uint64_t tick = 0; tick < 70; tick++) {
+        called += timers.advance();
+    }
+
+    CHECK(called == 64);
+    CHECK(timers.size() == 0);
+    CHECK(timers.now() == 75);
+
+    bool exact = true;
+    for (uint64_t i = 0; i < 64; i++) {
+        exact = exact && entries[i].calls == 1 && entries[i].fired == entries[i].expiry;
+    }
+    CHECK(exact);
+}
+
+static void testAdvanceMany() {
+    testCase("Advance many ticks at once");
+
+    Wheel timers;
+    wheel = &timers;
+
+    Timer first, second, clamped;
+    timers.schedule(Callback<void>(&first, &Timer::fire), 10);
+    timers.schedule(Callback<void>(&second, &Timer::fire), 40);
+    timers.schedule(Callback<void>(&clamped, &Timer::fire), 1000);
+
+    CHECK(timers.advance(9) == 0);
+    CHECK(timers.advance(40) == 2);
+    CHECK(first.fired == 10 && second.fired == 40);
+    CHECK(timers.advance(14) == 1);
+    CHECK(clamped.fired == Wheel::maxDelay);
+
+    // Nothing scheduled, only the time moves on
+    CHECK(timers.advance(1000) == 0);
+    CHECK(timers.now() == Wheel::maxDelay + 1000);
+}
+
+static void testCancel() {
+    testCase("Cancel");
+
+    Wheel timers;
+    wheel = &timers;
+
+    Timer canceled, kept;
+    const CallbackTimerHandle handle = timers.schedule(Callback<void>(&canceled, &Timer::fire), 20);
+    const CallbackTimerHandle other = timers.schedule(Callback<void>(&kept, &Timer::fire), 20);
+
+    CHECK(timers.cancel(handle));
+    CHECK(!timers.cancel(handle));
+    CHECK(!timers.isScheduled(handle));
+    CHECK(timers.size() == 1);
+
+    // The slot is reused, the old handle stays invalid
+    const CallbackTimerHandle reused = timers.schedule(Callback<void>(&canceled, &Timer::fire), 5);
+    CHECK(reused.index == handle.index);
+    CHECK(!timers.isScheduled(handle));
+    CHECK(!timers.cancel(handle));
+    CHECK(timers.isScheduled(reused));
+
+    timers.advance(20);
+    CHECK(canceled.calls == 1 && canceled.fired == 5);
+    CHECK(kept.calls == 1 && kept.fired == 20);
+
+    // Expired
+    CHECK(!timers.isScheduled(other));
+    CHECK(!timers.cancel(other));
+
+#ifdef CONFIG_CALLBACK_INCLUDE_POINT_TO_SAME
+    timers.schedule(Callback<void>(&kept, &Timer::fire), 3);
+    CHECK(timers.cancel(Callback<void>(&kept, &Timer::fire)));
+    CHECK(!timers.cancel(Callback<void>(&kept, &Timer::fire)));
+    CHECK(timers.size() == 0);
+#endif
+}
+
+// Reschedules itself every period ticks, until it ran often enough
+struct Periodic {
+    uint64_t period;
+    uint32_t remaining;
+    uint32_t calls = 0;
+
+    void fire() {
+        calls++;
+        if (--remaining > 0) {
+            wheel->schedule(Callback<void>(this, &Periodic::fire), period);
+        }
+    }
+};
+
+static void testReschedule() {
+    testCase("Reschedule from a Callback");
+
+    Wheel timers;
+    wheel = &timers;
+
+    Periodic periodic{7, 10};
+    timers.schedule(Callback<void>(&periodic, &Periodic::fire), periodic.period);
+
+    CHECK(timers.advance(69) == 9);
+    CHECK(timers.advance(1) == 1);
+    CHECK(periodic.calls == 10);
+    CHECK(timers.size() == 0);
+}
+
+int main() {
+    testExpiry();
+    testAdvanceMany();
+    testCancel();
+    testReschedule();
+
+    return testResult();
+}
@@ -0,0 +1,107 @@
+/**
+ * @author Timo Meyer (timoxd7@gmx.de)
+ * @brief Tests UniqueCallback: Functions, move-only and mutable Functors, moves, reset() and
+ * destruction of the owned Functor
+ *
+ * @copyright Copyright (c) 2024 Timo Meyer
+ *
+ */
+
+#include <memory>
+#include <utility>
+
+#include "callback_unique.hpp"
+#include "test.hpp"
+
+static int32_t twice(int32_t value) { return value * 2; }
+
+// Counts its living instances, so a Functor holding it is not trivially destructible
+struct Counted {
+    static int32_t alive;
+
+    Counted() { alive++; }
+    Counted(const Counted &) noexcept { alive++; }
+    ~Counted() { alive--; }
+};
+
+int32_t Counted::alive = 0;
+
+static void testCall() {
+    testCase("Functions, move-only and mutable Functors");
+
+    const UniqueCallback<int32_t, int32_t> empty;
+    UniqueCallback<int32_t, int32_t> null(nullptr);
+    CHECK(!empty.isCallbackSet());
+    CHECK(!null);
+    CHECK(null(1) == 0);
+
+    UniqueCallback<int32_t, int32_t> function(&twice);
+    CHECK(function.isCallbackSet());
+    CHECK(function(4) == 8);
+
+    std::unique_ptr<int32_t> owned(new int32_t(5));
+    UniqueCallback<int32_t, int32_t> add = [owned = std::move(owned)](int32_t value) {
+        return *owned + value;
+    };
+    CHECK(add(1) == 6);
+
+    int32_t calls = 0;
+    UniqueCallback<int32_t> counter = [calls]() mutable { return ++calls; };
+    counter();
+    CHECK(counter() == 2);
+
+    // Move-only Arguments are forwarded
+    UniqueCallback<int32_t, std::unique_ptr<int32_t>> take = [](std::unique_ptr<int32_t> value) {
+        return *value;
+    };
+    CHECK(take(std::unique_ptr<int32_t>(new int32_t(7))) == 7);
+}
+
+static void testOwnership() {
+    testCase("Moves, reset and destruction");
+
+    Counted::alive = 0;
+    {
+        const Counted counted;
+        UniqueCallback<int32_t> original = [counted]() { return Counted::alive; };
+        CHECK(Counted::alive == 2);
+
+        UniqueCallback<int32_t> moved(std::move(original));
+        CHECK(!original.isCallbackSet());
+        CHECK(Counted::alive == 2);
+        CHECK(moved() == 2);
+
+        original = std::move(moved);
+        CHECK(!moved.isCallbackSet());
+        CHECK(original() == 2);
+
+        // Replacing the Functor destroys the old one
+        original = [counted]() { return -Counted::alive; };
+        CHECK(Counted::alive == 2);
+        CHECK(original() == -2);
+
+        original.reset();
+        CHECK(!original.isCallbackSet());
+        CHECK(Counted::alive == 1);
+
+        UniqueCallback<int32_t> destroyed = [counted]() { return 0; };
+        CHECK(Counted::alive == 2);
+    }
+    CHECK(Counted::alive == 0);
+
+    testCase("Trivial Functors are moved bytewise");
+
+    int32_t value = 3;
+    UniqueCallback<int32_t> trivial = [&value]() { return value; };
+    UniqueCallback<int32_t> moved(std::move(trivial));
+    value = 4;
+    CHECK(moved() == 4);
+    CHECK(trivial() == 0);
+}
+
+int main() {
+    testCall();
+    testOwnership();
+
+    return testResult();
+}